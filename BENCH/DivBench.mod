@@ -0,0 +1,52 @@
+MODULE DivBench;
+
+PROCEDURE Div*(a, b: LONGINT): LONGINT;
+BEGIN
+  RETURN a DIV b
+END Div;
+
+PROCEDURE Mod*(a, b: LONGINT): LONGINT;
+BEGIN
+  RETURN a MOD b
+END Mod;
+
+PROCEDURE Div16*(a: LONGINT): LONGINT;
+BEGIN
+  RETURN a DIV 16
+END Div16;
+
+PROCEDURE Mod16*(a: LONGINT): LONGINT;
+BEGIN
+  RETURN a MOD 16
+END Mod16;
+
+PROCEDURE Ash3*(a: LONGINT): LONGINT;
+BEGIN
+  RETURN ASH(a, -3)
+END Ash3;
+
+PROCEDURE Run*(x, y: POINTER TO LONGINT; n: INTEGER): LONGINT;
+VAR i: INTEGER; s: LONGINT;
+BEGIN
+  s := 0;
+  i := 0;
+  WHILE i < n DO
+    s := s + x[i] DIV y[i] + x[i] MOD y[i];
+    INC(i)
+  END;
+  RETURN s
+END Run;
+
+PROCEDURE RunPow2*(x: POINTER TO LONGINT; n: INTEGER): LONGINT;
+VAR i: INTEGER; s: LONGINT;
+BEGIN
+  s := 0;
+  i := 0;
+  WHILE i < n DO
+    s := s + x[i] DIV 16 + x[i] MOD 16 + ASH(x[i], -3);
+    INC(i)
+  END;
+  RETURN s
+END RunPow2;
+
+END DivBench.
@@ -0,0 +1,326 @@
+MODULE Kernels;
+
+CONST
+MAXN = 2000000;
+MAXM = 160;
+MAXT = 4096;
+
+VAR
+flags: ARRAY MAXN OF BOOLEAN;
+data: ARRAY MAXN OF INTEGER;
+more: ARRAY MAXN OF INTEGER;
+saved: ARRAY MAXN OF INTEGER;
+text: ARRAY MAXT OF CHAR;
+count: INTEGER;
+ma: ARRAY MAXM * MAXM OF LONGREAL;
+mb: ARRAY MAXM * MAXM OF LONGREAL;
+mc: ARRAY MAXM * MAXM OF LONGREAL;
+ga, gb, gc: ARRAY MAXM, MAXM OF LONGREAL;
+seed: LONGINT;
+
+PROCEDURE Random(): INTEGER;
+BEGIN
+  seed := (seed * 1103515245 + 12345) MOD 2147483648;
+  RETURN seed DIV 65536
+END Random;
+
+PROCEDURE Sieve*(n: INTEGER): INTEGER;
+VAR i, k, count: INTEGER;
+BEGIN
+  i := 0;
+  WHILE i < n DO flags[i] := TRUE; INC(i) END;
+  count := 0;
+  i := 2;
+  WHILE i < n DO
+    IF flags[i] THEN
+      INC(count);
+      k := i + i;
+      WHILE k < n DO flags[k] := FALSE; k := k + i END
+    END;
+    INC(i)
+  END;
+  RETURN count
+END Sieve;
+
+PROCEDURE MatMul*(n: INTEGER): LONGREAL;
+VAR i, j, k: INTEGER; s, a, b: LONGREAL;
+BEGIN
+  a := 0.0;
+  b := 0.0;
+  i := 0;
+  WHILE i < n * n DO
+    a := a + 1.0;
+    IF a > 3.0 THEN a := -3.0 END;
+    b := b + 1.0;
+    IF b > 5.0 THEN b := 1.0 END;
+    ma[i] := a;
+    mb[i] := b;
+    INC(i)
+  END;
+  i := 0;
+  WHILE i < n DO
+    j := 0;
+    WHILE j < n DO
+      s := 0.0;
+      k := 0;
+      WHILE k < n DO
+        s := s + ma[i * n + k] * mb[k * n + j];
+        INC(k)
+      END;
+      mc[i * n + j] := s;
+      INC(j)
+    END;
+    INC(i)
+  END;
+  s := 0.0;
+  i := 0;
+  WHILE i < n DO s := s + mc[i * n + i]; INC(i) END;
+  RETURN s
+END MatMul;
+
+PROCEDURE Grid*(n: INTEGER): LONGREAL;
+VAR i, j, k: INTEGER; s, a, b: LONGREAL;
+BEGIN
+  a := 0.0;
+  b := 0.0;
+  i := 0;
+  WHILE i < n DO
+    j := 0;
+    WHILE j < n DO
+      a := a + 1.0;
+      IF a > 3.0 THEN a := -3.0 END;
+      b := b + 1.0;
+      IF b > 5.0 THEN b := 1.0 END;
+      ga[i, j] := a;
+      gb[i, j] := b;
+      INC(j)
+    END;
+    INC(i)
+  END;
+  i := 0;
+  WHILE i < n DO
+    j := 0;
+    WHILE j < n DO
+      s := 0.0;
+      k := 0;
+      WHILE k < n DO
+        s := s + ga[i, k] * gb[k, j];
+        INC(k)
+      END;
+      gc[i, j] := s;
+      INC(j)
+    END;
+    INC(i)
+  END;
+  s := 0.0;
+  i := 0;
+  WHILE i < n DO s := s + gc[i, i]; INC(i) END;
+  RETURN s
+END Grid;
+
+PROCEDURE Fib*(n: INTEGER): INTEGER;
+BEGIN
+  IF n < 2 THEN RETURN n END;
+  RETURN Fib(n - 1) + Fib(n - 2)
+END Fib;
+
+PROCEDURE QuickSort(lo, hi: INTEGER);
+VAR i, j, p, t: INTEGER;
+BEGIN
+  WHILE lo < hi DO
+    p := data[(lo + hi) DIV 2];
+    i := lo;
+    j := hi;
+    REPEAT
+      WHILE data[i] < p DO INC(i) END;
+      WHILE data[j] > p DO DEC(j) END;
+      IF i <= j THEN
+        t := data[i]; data[i] := data[j]; data[j] := t;
+        INC(i);
+        DEC(j)
+      END
+    UNTIL i > j;
+    IF j - lo < hi - i THEN
+      QuickSort(lo, j);
+      lo := i
+    ELSE
+      QuickSort(i, hi);
+      hi := j
+    END
+  END
+END QuickSort;
+
+PROCEDURE Sort*(n: INTEGER): INTEGER;
+VAR i, bad: INTEGER;
+BEGIN
+  seed := 1;
+  i := 0;
+  WHILE i < n DO data[i] := Random(); INC(i) END;
+  QuickSort(0, n - 1);
+  bad := 0;
+  i := 1;
+  WHILE i < n DO
+    IF data[i - 1] > data[i] THEN INC(bad) END;
+    INC(i)
+  END;
+  RETURN bad
+END Sort;
+
+PROCEDURE Digits*(n: INTEGER): LONGINT;
+VAR i, k: INTEGER; s: LONGINT;
+BEGIN
+  s := 0;
+  i := 1;
+  WHILE i <= n DO
+    k := i;
+    WHILE k > 0 DO
+      s := s + k MOD 10;
+      k := k DIV 10
+    END;
+    INC(i)
+  END;
+  RETURN s
+END Digits;
+
+PROCEDURE Total(v: ARRAY OF INTEGER): LONGINT;
+VAR i: INTEGER; s: LONGINT;
+BEGIN
+  s := 0;
+  i := 0;
+  WHILE i < LEN(v) DO s := s + v[i]; INC(i) END;
+  RETURN s
+END Total;
+
+PROCEDURE Shift(VAR v: ARRAY OF INTEGER; x: INTEGER);
+VAR i: INTEGER;
+BEGIN
+  i := 0;
+  WHILE i < LEN(v) DO v[i] := v[i] + x; INC(i) END
+END Shift;
+
+PROCEDURE Round(VAR v: ARRAY OF INTEGER; x: INTEGER): LONGINT;
+VAR s: LONGINT;
+BEGIN
+  Shift(v, x);
+  s := Total(v);
+  Shift(v, -x);
+  RETURN s
+END Round;
+
+PROCEDURE Pass(VAR v: ARRAY OF INTEGER; x: INTEGER): LONGINT;
+BEGIN
+  RETURN Round(v, x) - Total(v)
+END Pass;
+
+PROCEDURE Buffers*(n: INTEGER): LONGINT;
+VAR i: INTEGER; s: LONGINT;
+BEGIN
+  i := 0;
+  WHILE i < MAXN DO data[i] := i MOD 7; INC(i) END;
+  s := 0;
+  i := 1;
+  WHILE i <= n DO s := s + Pass(data, i); INC(i) END;
+  RETURN s
+END Buffers;
+
+PROCEDURE Prepare;
+VAR i: INTEGER;
+BEGIN
+  count := MAXN;
+  FOR i := 0 TO MAXN - 1 DO data[i] := i MOD 7; more[i] := 0 END;
+  FOR i := 0 TO MAXT - 2 DO text[i] := CHR(97 + i MOD 5) END;
+  text[MAXT - 1] := 0X
+END Prepare;
+
+PROCEDURE AddWhile*(n: INTEGER): LONGINT;
+VAR i, r: INTEGER;
+BEGIN
+  Prepare;
+  r := 0;
+  WHILE r < n DO
+    i := 0;
+    WHILE i < count DO more[i] := more[i] + data[i]; INC(i) END;
+    INC(r)
+  END;
+  RETURN Total(more)
+END AddWhile;
+
+PROCEDURE AddFor*(n: INTEGER): LONGINT;
+VAR i, r: INTEGER;
+BEGIN
+  Prepare;
+  FOR r := 1 TO n DO
+    FOR i := 0 TO count - 1 DO more[i] := more[i] + data[i] END
+  END;
+  RETURN Total(more)
+END AddFor;
+
+PROCEDURE Length(s: ARRAY OF CHAR): INTEGER;
+VAR i: INTEGER;
+BEGIN
+  i := 0;
+  WHILE (i < LEN(s)) & (s[i] # 0X) DO INC(i) END;
+  RETURN i
+END Length;
+
+PROCEDURE ScanWhile*(n: INTEGER): INTEGER;
+VAR i, r, c: INTEGER;
+BEGIN
+  Prepare;
+  c := 0;
+  r := 0;
+  WHILE r < n DO
+    i := 0;
+    WHILE i < Length(text) DO
+      IF text[i] = 'a' THEN INC(c) END;
+      INC(i)
+    END;
+    INC(r)
+  END;
+  RETURN c
+END ScanWhile;
+
+PROCEDURE ScanFor*(n: INTEGER): INTEGER;
+VAR i, r, c: INTEGER;
+BEGIN
+  Prepare;
+  c := 0;
+  FOR r := 1 TO n DO
+    FOR i := 0 TO Length(text) - 1 DO
+      IF text[i] = 'a' THEN INC(c) END
+    END
+  END;
+  RETURN c
+END ScanFor;
+
+PROCEDURE ResetLoop*(n: INTEGER): LONGINT;
+VAR i, r: INTEGER; s: LONGINT;
+BEGIN
+  Prepare;
+  s := 0;
+  FOR r := 1 TO n DO
+    FOR i := 0 TO MAXN - 1 DO saved[i] := data[i] END;
+    FOR i := 0 TO MAXN - 1 DO more[i] := r END;
+    FOR i := 0 TO MAXN - 1 DO more[i] := more[i] + saved[i] END;
+    FOR i := 0 TO MAXN - 1 DO more[i] := more[i] * 2 END;
+    FOR i := 0 TO MAXN - 1 DO s := s + more[i] END
+  END;
+  RETURN s
+END ResetLoop;
+
+PROCEDURE ResetVec*(n: INTEGER): LONGINT;
+VAR r: INTEGER; s: LONGINT;
+BEGIN
+  Prepare;
+  s := 0;
+  FOR r := 1 TO n DO
+    saved := data;
+    FILL(more, r);
+    VADD(more, more, saved);
+    VSCALE(more, more, 2);
+    s := s + VSUM(more)
+  END;
+  RETURN s
+END ResetVec;
+
+END Kernels.
@@ -0,0 +1,97 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "DivBench.h"
+
+#define N 4096
+#define ROUNDS 20000
+
+long xs[N], ys[N];
+
+long naiveDiv(long a, long b) {
+    long q = a / b;
+    if (a % b != 0 && (a < 0) != (b < 0)) q--;
+    return q;
+}
+
+long naiveMod(long a, long b) {
+    long r = a % b;
+    if (r != 0 && (r < 0) != (b < 0)) r += b;
+    return r;
+}
+
+long runNaive(long *x, long *y, int n) {
+    long s = 0;
+    int i;
+    for (i = 0; i < n; i++) s += naiveDiv(x[i], y[i]) + naiveMod(x[i], y[i]);
+    return s;
+}
+
+long runTrunc(long *x, long *y, int n) {
+    long s = 0;
+    int i;
+    for (i = 0; i < n; i++) s += x[i] / y[i] + x[i] % y[i];
+    return s;
+}
+
+long runNaivePow2(long *x, int n) {
+    long s = 0;
+    int i;
+    for (i = 0; i < n; i++) s += naiveDiv(x[i], 16) + naiveMod(x[i], 16) + naiveDiv(x[i], 8);
+    return s;
+}
+
+long randomSigned(long range) {
+    long v = (((long)rand() << 15) ^ rand()) % range;
+    return rand() & 1 ? -v : v;
+}
+
+int check(void) {
+    long a, b, q, r, i, bad = 0;
+    for (i = 0; i < 1000000; i++) {
+        a = randomSigned(1L << 30);
+        b = randomSigned(i & 1 ? 1000 : 1L << 20);
+        if (b == 0) b = 1;
+        q = (long)floor((double)a / (double)b);
+        r = a - q * b;
+        if (DivBench_Div(a, b) != q || DivBench_Mod(a, b) != r) bad++;
+        q = (long)floor((double)a / 16.0);
+        if (DivBench_Div16(a) != q || DivBench_Mod16(a) != a - q * 16) bad++;
+        if (DivBench_Ash3(a) != (long)floor((double)a / 8.0)) bad++;
+    }
+    printf("check: %ld mismatches in %ld cases\n", bad, i);
+    return bad == 0;
+}
+
+double seconds(clock_t t) {
+    return (double)(clock() - t) / CLOCKS_PER_SEC;
+}
+
+int main(void) {
+    clock_t t;
+    long s;
+    int i, k;
+    srand(1);
+    for (i = 0; i < N; i++) {
+        xs[i] = randomSigned(1L << 30);
+        do ys[i] = randomSigned(1000); while (ys[i] == 0);
+    }
+    if (!check()) return 1;
+    t = clock(); s = 0;
+    for (k = 0; k < ROUNDS; k++) s += runTrunc(xs, ys, N);
+    printf("C / and %% (wrong)    %6.3fs  %ld\n", seconds(t), s);
+    t = clock(); s = 0;
+    for (k = 0; k < ROUNDS; k++) s += runNaive(xs, ys, N);
+    printf("sign tests           %6.3fs  %ld\n", seconds(t), s);
+    t = clock(); s = 0;
+    for (k = 0; k < ROUNDS; k++) s += DivBench_Run(xs, ys, N);
+    printf("DIV/MOD              %6.3fs  %ld\n", seconds(t), s);
+    t = clock(); s = 0;
+    for (k = 0; k < ROUNDS; k++) s += runNaivePow2(xs, N);
+    printf("sign tests, 2^k      %6.3fs  %ld\n", seconds(t), s);
+    t = clock(); s = 0;
+    for (k = 0; k < ROUNDS; k++) s += DivBench_RunPow2(xs, N);
+    printf("DIV/MOD/ASH, 2^k     %6.3fs  %ld\n", seconds(t), s);
+    return 0;
+}
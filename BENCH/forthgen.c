@@ -0,0 +1,16 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+int main(int argc, char **argv) {
+    long i, lines = argc > 1 ? atol(argv[1]) : 100000;
+    printf(": SQ DUP * ;\n");
+    printf(": CUBE DUP SQ * ;\n");
+    printf(": POKE HERE ! HERE @ ;\n");
+    printf(": MIX 3 CUBE 7 SQ + 100 SWAP - POKE DROP ;\n");
+    printf(": STEP MIX MIX 1 2 OVER OVER + + + DROP ;\n");
+    for (i = 0; i < lines; i++) {
+        printf("STEP STEP STEP STEP %ld %ld + DROP\n", i, i % 97);
+    }
+    printf("BYE\n");
+    return 0;
+}
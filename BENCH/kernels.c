@@ -0,0 +1,60 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "Kernels.h"
+
+#define RUNS 5
+
+int failed = 0;
+
+double seconds(clock_t t) {
+    return (double)(clock() - t) / CLOCKS_PER_SEC;
+}
+
+void report(const char *name, long n, double result, double expect, double s) {
+    printf("kernel name=%s n=%ld result=%.0f best_s=%.4f%s\n", name, n, result, s,
+        result == expect ? "" : " WRONG");
+    if (result != expect) failed = 1;
+}
+
+#define TIME(k, reps, expr) \
+    t = clock(); \
+    for (j = 0; j < reps; j++) r[k] = expr; \
+    if (seconds(t) < s[k]) s[k] = seconds(t);
+
+int main(void) {
+    clock_t t;
+    double r[13], s[13];
+    int i, j, k;
+    mod_Kernels_init();
+    for (k = 0; k < 13; k++) s[k] = 1e9;
+    for (i = 0; i < RUNS; i++) {
+        TIME(0, 10, Kernels_Sieve(2000000));
+        TIME(1, 30, Kernels_MatMul(160));
+        TIME(2, 3, Kernels_Fib(36));
+        TIME(3, 1, Kernels_Sort(1000000));
+        TIME(4, 4, (double)Kernels_Digits(3000000));
+        TIME(5, 4, (double)Kernels_Buffers(10));
+        TIME(6, 30, Kernels_Grid(160));
+        TIME(7, 1, (double)Kernels_AddWhile(50));
+        TIME(8, 1, (double)Kernels_AddFor(50));
+        TIME(9, 1, Kernels_ScanWhile(10));
+        TIME(10, 1, Kernels_ScanFor(10));
+        TIME(11, 1, (double)Kernels_ResetLoop(20));
+        TIME(12, 1, (double)Kernels_ResetVec(20));
+    }
+    report("sieve", 2000000, r[0], 148933, s[0]);
+    report("matmul", 160, r[1], -6, s[1]);
+    report("fib", 36, r[2], 14930352, s[2]);
+    report("sort", 1000000, r[3], 0, s[3]);
+    report("digits", 3000000, r[4], 84000003, s[4]);
+    report("buffers", 10, r[5], 110000000, s[5]);
+    report("grid", 160, r[6], -6, s[6]);
+    report("add-while", 50, r[7], 299999750, s[7]);
+    report("add-for", 50, r[8], 299999750, s[8]);
+    report("scan-while", 10, r[9], 8190, s[9]);
+    report("scan-for", 10, r[10], 8190, s[10]);
+    report("reset-loop", 20, r[11], 1079999800, s[11]);
+    report("reset-vec", 20, r[12], 1079999800, s[12]);
+    return failed;
+}
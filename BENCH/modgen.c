@@ -0,0 +1,83 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+/* modgen PROCS DEPTH CONSTS VARS IMPORTS INJECT
+   writes Gen.mod and the modules Imp0.mod .. ImpN.mod it imports */
+
+FILE *out;
+
+void openModule(const char *name) {
+    out = fopen(name, "w");
+    if (out == NULL) {
+        printf("Error: Cannot create %s\n", name);
+        exit(1);
+    }
+}
+
+void expression(int depth, long k, int consts, int vars, int imports) {
+    int i;
+    static const char *ops[4] = { " + ", " - ", " * ", " + " };
+    for (i = 0; i < depth; i++) {
+        if (i % 3 == 0) fprintf(out, "(x%s", ops[i & 3]);
+        else if (i % 3 == 1) fprintf(out, "(K%ld%s", (k + i) % consts, ops[i & 3]);
+        else fprintf(out, "(G%ld%s", (k + i) % vars, ops[i & 3]);
+    }
+    if (imports > 0) fprintf(out, "Imp%ld.V", k % imports);
+    else fprintf(out, "y");
+    for (i = 0; i < depth; i++) fputc(')', out);
+}
+
+int main(int argc, char **argv) {
+    long procs, k;
+    int depth, consts, vars, imports, inject, i;
+    char name[32];
+    if (argc != 7) {
+        printf("Usage: %s PROCS DEPTH CONSTS VARS IMPORTS INJECT\n", argv[0]);
+        return 1;
+    }
+    procs = atol(argv[1]);
+    depth = atoi(argv[2]);
+    consts = atoi(argv[3]);
+    vars = atoi(argv[4]);
+    imports = atoi(argv[5]);
+    inject = atoi(argv[6]);
+    if (consts < 1) consts = 1;
+    if (vars < 1) vars = 1;
+    for (i = 0; i < imports; i++) {
+        sprintf(name, "Imp%d.mod", i);
+        openModule(name);
+        fprintf(out, "MODULE Imp%d;\n\nCONST\nC* = %d;\n\nVAR\nV*: INTEGER;\n\n", i, i);
+        fprintf(out, "PROCEDURE F*(a, b: INTEGER): INTEGER;\nBEGIN\n  RETURN a + b * C\nEND F;\n\n");
+        fprintf(out, "BEGIN\n  V := C\nEND Imp%d.\n", i);
+        fclose(out);
+    }
+    openModule("Gen.mod");
+    fprintf(out, "MODULE Gen;\n\n");
+    if (imports > 0) {
+        fprintf(out, "IMPORT ");
+        for (i = 0; i < imports; i++) fprintf(out, i ? ", Imp%d" : "Imp%d", i);
+        fprintf(out, ";\n\n");
+    }
+    fprintf(out, "CONST\nK0 = 1;\n");
+    for (i = 1; i < consts; i++) fprintf(out, "K%d = K%d * 3 + %d;\n", i, i - 1, i % 7);
+    fprintf(out, "\nVAR\n");
+    for (i = 0; i < vars; i++) fprintf(out, "G%d: INTEGER;\n", i);
+    fprintf(out, "A: ARRAY 64 OF INTEGER;\n\n");
+    if (inject > 0) {
+        fprintf(out, "(*{\n");
+        for (i = 0; i < inject; i++) fprintf(out, "static int Gen_inject%d(int x) { return x * %d + %d; }\n", i, i % 13, i);
+        fprintf(out, "*)\n\n");
+    }
+    for (k = 0; k < procs; k++) {
+        fprintf(out, "PROCEDURE P%ld(x, y: INTEGER): INTEGER;\nVAR i, s: INTEGER;\nBEGIN\n  s := ", k);
+        expression(depth, k, consts, vars, imports);
+        fprintf(out, ";\n  i := 0;\n  WHILE i < x DO\n    IF ODD(i) THEN\n      s := s + ");
+        if (imports > 0) fprintf(out, "Imp%ld.F(i, G%ld)", k % imports, k % vars);
+        else fprintf(out, "G%ld", k % vars);
+        fprintf(out, "\n    ELSIF i < 64 THEN\n      s := s - A[i] DIV 4\n    END;\n    INC(i)\n  END;\n");
+        fprintf(out, "  RETURN s\nEND P%ld;\n\n", k);
+    }
+    fprintf(out, "BEGIN\n  G0 := P0(3, 4)\nEND Gen.\n");
+    fclose(out);
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+/* runbench [-w] NAME RUNS INPUT PROGRAM [ARGS...]
+   runs PROGRAM RUNS times with INPUT on stdin and prints the best
+   user + system time, or with -w the best wall-clock time */
+
+double wallSeconds(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+double childSeconds(void) {
+    struct rusage r;
+    getrusage(RUSAGE_CHILDREN, &r);
+    return r.ru_utime.tv_sec + r.ru_stime.tv_sec + (r.ru_utime.tv_usec + r.ru_stime.tv_usec) / 1e6;
+}
+
+int main(int argc, char **argv) {
+    int runs, i, fd, st, wall = 0;
+    double t, best = 1e9;
+    char *prog = argv[0];
+    pid_t pid;
+    if (argc > 1 && argv[1][0] == '-' && argv[1][1] == 'w') {
+        wall = 1;
+        argc--;
+        argv++;
+    }
+    if (argc < 5) {
+        printf("Usage: %s [-w] NAME RUNS INPUT PROGRAM [ARGS...]\n", prog);
+        return 1;
+    }
+    runs = atoi(argv[2]);
+    for (i = 0; i < runs; i++) {
+        t = wall ? wallSeconds() : childSeconds();
+        pid = fork();
+        if (pid < 0) return 1;
+        if (pid == 0) {
+            fd = open(argv[3], O_RDONLY);
+            if (fd < 0) _exit(127);
+            dup2(fd, 0);
+            fd = open("/dev/null", O_WRONLY);
+            dup2(fd, 1);
+            dup2(fd, 2);
+            execv(argv[4], argv + 4);
+            _exit(127);
+        }
+        waitpid(pid, &st, 0);
+        if (!WIFEXITED(st) || WEXITSTATUS(st) != 0) {
+            printf("run name=%s failed\n", argv[1]);
+            return 1;
+        }
+        t = (wall ? wallSeconds() : childSeconds()) - t;
+        if (t < best) best = t;
+    }
+    printf("run name=%s runs=%d best_s=%.4f\n", argv[1], runs, best);
+    return 0;
+}
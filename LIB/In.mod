@@ -16,7 +16,12 @@ END Open;
 PROCEDURE Char*(p : POINTER TO CHAR);
 BEGIN
 (*{
-*In_p = getc();
+int c = getc(stdin);
+if (c == EOF) {
+    In_Done = false;
+    c = 0;
+}
+*In_p = (char)c;
 *)
 END Char;
 
@@ -21,7 +21,7 @@ END String;
 
 PROCEDURE Int*(i, n: LONGINT);
 BEGIN
-(*{ printf("%d", Out_i); *)
+(*{ printf("%ld", Out_i); *)
 END Int;
 
 (*
@@ -0,0 +1,186 @@
+(*  (c) by DosWorld is marked CC0 1.0 Universal.
+    To view a copy of this mark,
+    visit https://creativecommons.org/publicdomain/zero/1.0/  *)
+
+MODULE Prof;
+
+(*#
+
+#ifndef Prof_MASK
+#define Prof_MASK 1023
+#endif
+
+#ifndef Prof_FILE
+#define Prof_FILE "sobt.prof"
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define Prof_Now()  ((uint64_t)__rdtsc())
+#define Prof_UNIT   "cycles"
+#else
+#include <time.h>
+#define Prof_Now()  ((uint64_t)clock())
+#define Prof_UNIT   "clock ticks"
+#endif
+
+#ifdef __GNUC__
+#define Prof_ALIGN  __attribute__((aligned(64)))
+#define Prof_INIT   __attribute__((constructor))
+#define Prof_COLD   __attribute__((noinline, cold))
+#else
+#define Prof_ALIGN
+#define Prof_INIT
+#define Prof_COLD
+#endif
+
+#define Prof_Skip(c)     ((c)[0]++ & Prof_MASK)
+#define Prof_Leave(c, t) ((c)[2] += Prof_Now() - (t), (c)[1]++)
+#define Prof_Branch(c, x) ((c)[0]++, (x) ? ((c)[1]++, 1) : 0)
+
+void Prof_Add(const char *name, uint64_t *counters);
+void Prof_Module(const char *name, const char *hash, uint64_t *branches, const int *lines, int count);
+
+*)
+
+CONST
+CAPACITY = 64;
+
+(*{
+#include <stdio.h>
+
+static const char **Prof_names = NULL;
+static uint64_t **Prof_counters = NULL;
+static int Prof_count = 0;
+static int Prof_capacity = 0;
+static uint64_t Prof_start;
+static int Prof_started = 0;
+
+static const char **Prof_modNames = NULL;
+static const char **Prof_modHashes = NULL;
+static uint64_t **Prof_modBranches = NULL;
+static const int **Prof_modLines = NULL;
+static int *Prof_modCounts = NULL;
+static int Prof_modCount = 0;
+static int Prof_modCapacity = 0;
+
+static void Prof_AtExit(void) {
+  Prof_Report();
+  if (Prof_modCount > 0) Prof_Save();
+}
+
+static void Prof_Start(void) {
+  if (Prof_started) return;
+  Prof_started = 1;
+  Prof_start = Prof_Now();
+  atexit(Prof_AtExit);
+}
+
+void Prof_Add(const char *name, uint64_t *counters) {
+  Prof_Start();
+  if (Prof_count >= Prof_capacity) {
+    Prof_capacity = Prof_capacity ? Prof_capacity * 2 : Prof_CAPACITY;
+    Prof_names = realloc(Prof_names, Prof_capacity * sizeof *Prof_names);
+    Prof_counters = realloc(Prof_counters, Prof_capacity * sizeof *Prof_counters);
+    if (Prof_names == NULL || Prof_counters == NULL) abort();
+  }
+  Prof_names[Prof_count] = name;
+  Prof_counters[Prof_count] = counters;
+  Prof_count++;
+}
+
+void Prof_Module(const char *name, const char *hash, uint64_t *branches, const int *lines, int count) {
+  Prof_Start();
+  if (Prof_modCount >= Prof_modCapacity) {
+    Prof_modCapacity = Prof_modCapacity ? Prof_modCapacity * 2 : Prof_CAPACITY;
+    Prof_modNames = realloc(Prof_modNames, Prof_modCapacity * sizeof *Prof_modNames);
+    Prof_modHashes = realloc(Prof_modHashes, Prof_modCapacity * sizeof *Prof_modHashes);
+    Prof_modBranches = realloc(Prof_modBranches, Prof_modCapacity * sizeof *Prof_modBranches);
+    Prof_modLines = realloc(Prof_modLines, Prof_modCapacity * sizeof *Prof_modLines);
+    Prof_modCounts = realloc(Prof_modCounts, Prof_modCapacity * sizeof *Prof_modCounts);
+    if (Prof_modNames == NULL || Prof_modHashes == NULL || Prof_modBranches == NULL
+      || Prof_modLines == NULL || Prof_modCounts == NULL) abort();
+  }
+  Prof_modNames[Prof_modCount] = name;
+  Prof_modHashes[Prof_modCount] = hash;
+  Prof_modBranches[Prof_modCount] = branches;
+  Prof_modLines[Prof_modCount] = lines;
+  Prof_modCounts[Prof_modCount] = count;
+  Prof_modCount++;
+}
+
+static double Prof_Estimate(int i) {
+  uint64_t *c = Prof_counters[i];
+  return c[1] ? (double)c[2] * (double)c[0] / (double)c[1] : 0.0;
+}
+
+static int Prof_Compare(const void *a, const void *b) {
+  const int *i = a, *j = b;
+  double x = Prof_Estimate(*i), y = Prof_Estimate(*j);
+  return (x < y) - (x > y);
+}
+*)
+
+PROCEDURE Report*;
+BEGIN
+(*{
+  int i, *order;
+  double total = (double)(Prof_Now() - Prof_start), t;
+  uint64_t *c;
+  if (Prof_count == 0) return;
+  order = malloc(Prof_count * sizeof(int));
+  if (order == NULL) return;
+  for (i = 0; i < Prof_count; i++) order[i] = i;
+  qsort(order, Prof_count, sizeof(int), Prof_Compare);
+  fprintf(stderr, "%12s %14s %6s %12s  %s (%s, 1 in %d calls timed)\n",
+    "calls", "total", "%", "per call", "procedure", Prof_UNIT, Prof_MASK + 1);
+  for (i = 0; i < Prof_count; i++) {
+    c = Prof_counters[order[i]];
+    if (c[0] == 0) continue;
+    t = Prof_Estimate(order[i]);
+    fprintf(stderr, "%12lu %14.0f %6.2f %12.1f  %s\n", (unsigned long)c[0], t,
+      total > 0 ? 100.0 * t / total : 0.0, t / (double)c[0], Prof_names[order[i]]);
+  }
+  free(order);
+*)
+END Report;
+
+PROCEDURE Save*;
+BEGIN
+(*{
+  int i, k;
+  const char *name = getenv("PROF_FILE");
+  FILE *f = fopen(name ? name : Prof_FILE, "w");
+  if (f == NULL) return;
+  fprintf(f, "# sobt profile\n");
+  for (i = 0; i < Prof_modCount; i++) {
+    fprintf(f, "M %s %s\n", Prof_modNames[i], Prof_modHashes[i]);
+    for (k = 0; k < Prof_modCounts[i]; k++) {
+      fprintf(f, "B %s %d %d %lu %lu\n", Prof_modNames[i], k, Prof_modLines[i][k],
+        (unsigned long)Prof_modBranches[i][2 * k], (unsigned long)Prof_modBranches[i][2 * k + 1]);
+    }
+  }
+  for (i = 0; i < Prof_count; i++) {
+    fprintf(f, "P %s %lu\n", Prof_names[i], (unsigned long)Prof_counters[i][0]);
+  }
+  fclose(f);
+*)
+END Save;
+
+PROCEDURE Reset*;
+BEGIN
+(*{
+  int i, k;
+  for (i = 0; i < Prof_count; i++) {
+    Prof_counters[i][0] = 0;
+    Prof_counters[i][1] = 0;
+    Prof_counters[i][2] = 0;
+  }
+  for (i = 0; i < Prof_modCount; i++) {
+    for (k = 0; k < 2 * Prof_modCounts[i]; k++) Prof_modBranches[i][k] = 0;
+  }
+  Prof_start = Prof_Now();
+*)
+END Reset;
+
+END Prof.
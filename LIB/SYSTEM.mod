@@ -8,7 +8,7 @@ MODULE SYSTEM;
 
 #define SYSTEM_BitAnd(a, b) ((a) & (b))
 #define SYSTEM_BitOr(a, b)  ((a) | (b))
-#define SYSTEM_BitNot(a)    (!(a))
+#define SYSTEM_BitNot(a)    (~(a))
 #define SYSTEM_BitXor(a, b) ((a) ^ (b))
 
 #define SYSTEM_SHL(a, b) ((a) << (b))
@@ -1,11 +1,50 @@
+#if defined(__linux__) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 #include <math.h>
+#include <stdarg.h>
+#include <setjmp.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <signal.h>
+#include <poll.h>
+#define HAVEFORK 1
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <dirent.h>
+#define HAVEINOTIFY 1
+#endif
+#else
+#include <time.h>
+#endif
+
+#ifdef SOBTLIB
+#include "sobt.h"
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#define THREADLOCAL _Thread_local
+#elif defined(_MSC_VER)
+#define THREADLOCAL __declspec(thread)
+#else
+#define THREADLOCAL __thread
+#endif
+#else
+#define THREADLOCAL
+#endif
 
 #define MAXIDLEN 32
-#define MAXTYPELEN 32
+#define MAXTYPELEN (MAXIDLEN * 2 + 16)
 #define MAXFNAMELEN 256
 #define STABSIZE 512
 #define STABBUFSIZE (8 * 1024)
@@ -35,6 +74,14 @@
 #define TDEC 22
 #define TBREAK 23
 #define TCONT 24
+#define TRECORD 25
+#define TTYPE 26
+#define TCASE 27
+#define TFOR 28
+#define TBY 29
+#define TFILL 30
+#define TVADD 31
+#define TVSCALE 32
 
 #define TTYPEINT 100
 #define TTYPELONG 101
@@ -50,6 +97,9 @@
 #define TFORD 114
 #define TFCHR 115
 #define TFFLOOR 116
+#define TFLEN 117
+#define TFVSUM 118
+#define TFVDOT 119
 
 #define TIDENT 50
 #define TNUMBER 51
@@ -81,10 +131,12 @@
 #define TCOLON 85
 #define TSEMICOL 86
 #define TDOT 87
+#define TBAR 88
+#define TUPTO 89
+#define TNIL 90
+#define TTRUE 91
+#define TFALSE 92
 #define TEOF 99
-#define TNIL 103
-#define TTRUE 101
-#define TFALSE 102
 
 #define TSYMTHISMOD 200
 #define TSYMIMOD 201
@@ -95,62 +147,346 @@
 #define TSYMGVAR 302
 #define TSYMGEVAR 303
 #define TSYMPARAM 304
+#define TSYMTYPE 305
+#define TSYMVARPARAM 306
+
+#define SYMMAGIC "SOBTSYM2"
+
+#define IRRAW 1
+#define IRSTMT 2
+#define IRJUMP 3
+#define IRIF 4
+#define IRELSIF 5
+#define IRELSE 6
+#define IREND 7
+#define IRWHILE 8
+#define IRREPEAT 9
+#define IRUNTIL 10
+#define IRCASE 11
+#define IRLABEL 12
+#define IRFOR 13
+
+#define BUFC 0
+#define BUFH 1
+#define BUFLHS 2
+#define BUFARGS 3
+#define BUFSYM 4
+#define BUFCONST 5
+#define BUFIR 6
+#define BUFCHECK 7
+#define BUFHOIST 8
+#define BUFLINES 9
+#define BUFPROF 10
+#define BUFDIAG 11
+#define BUFWRAP 12
+#define BUFCOUNT 13
+#define MAXCHECKED 16
+#define PROFHOT 100
+#define PROFMINCOUNT 16
+#define BUFINITSIZE 1024
+#define CACHELINE 64
+#define MAXCASERANGE 1024
+#define MINDENSECASE 4
+#define CASESWITCH 0
+#define CASETABLE 1
+#define CASEIF 2
+
+#define STATLINES 0
+#define STATTOKENS 1
+#define STATLEX 2
+#define STATPARSE 3
+#define STATEMIT 4
+#define STATTIME 5
+#define STATLOOKUPS 6
+#define STATPROBES 7
+#define STATSYMBOLS 8
+#define STATTYPES 9
+#define STATCBYTES 10
+#define STATHBYTES 11
+#define STATALLOC 12
+#define STATCOUNT 13
+#define STATSAMPLE 16
+
+THREADLOCAL char *bufferData[BUFCOUNT];
+THREADLOCAL long bufferLen[BUFCOUNT];
+THREADLOCAL long bufferSize[BUFCOUNT];
+THREADLOCAL int emitBuffer = BUFC;
+
+THREADLOCAL char *sourceBuffer = NULL;
+THREADLOCAL char *sourcePtr;
+THREADLOCAL char *sourceEnd;
+
+THREADLOCAL int currentLine = 1;
+THREADLOCAL int currentSymbol = 0;
+THREADLOCAL char currentToken[MAXIDLEN];
+THREADLOCAL char moduleName[MAXIDLEN];
+
+THREADLOCAL char sourceFileName[MAXFNAMELEN];
+THREADLOCAL char outputNameC[MAXFNAMELEN];
+THREADLOCAL char outputNameHeader[MAXFNAMELEN];
+THREADLOCAL char outputNameCache[MAXFNAMELEN];
+THREADLOCAL char outputNameSym[MAXFNAMELEN];
+THREADLOCAL char translateOptions[MAXFNAMELEN];
+
+THREADLOCAL int incrementalMode = 0;
+THREADLOCAL unsigned long sourceHash;
+THREADLOCAL int symChanged;
+
+THREADLOCAL int diagToBuffer = 0;
+THREADLOCAL int errorJump = 0;
+THREADLOCAL jmp_buf translationAbort;
+THREADLOCAL int serverMode = 0;
+THREADLOCAL int serverStop = 0;
+THREADLOCAL char serverDir[MAXFNAMELEN];
+THREADLOCAL char **watchQueue = NULL;
+THREADLOCAL int watchHead, watchCount;
+THREADLOCAL int watchCapacity = 0;
+
+THREADLOCAL int isGlobalDefinition;
+THREADLOCAL int headerDirectives;
+THREADLOCAL int optimizeMode = 0;
+THREADLOCAL int boundsMode = 0;
+THREADLOCAL int linesMode = 0;
+THREADLOCAL int profMode = 0;
+THREADLOCAL int layoutMode = 0;
+THREADLOCAL int gotoMode = 0;
+THREADLOCAL int curProcIndex;
+THREADLOCAL int curProcExported;
+THREADLOCAL long *profSig = NULL;
+THREADLOCAL long *profBody = NULL;
+THREADLOCAL long *profWrap = NULL;
+THREADLOCAL long *profSplit = NULL;
+THREADLOCAL int *profExp = NULL;
+THREADLOCAL int *profHot = NULL;
+THREADLOCAL int *profLeaf = NULL;
+THREADLOCAL int procLeaf;
+THREADLOCAL int profProcCount;
+THREADLOCAL int profProcCapacity = 0;
+THREADLOCAL long procSignature;
+THREADLOCAL long procBody;
+THREADLOCAL int loopHeader;
+
+THREADLOCAL int exprConst;
+THREADLOCAL long exprIntVal;
+THREADLOCAL double exprRealVal;
+THREADLOCAL char constValueBuf[64];
+THREADLOCAL int exprLocal;
+THREADLOCAL int plainVar;
+THREADLOCAL int desOpen;
+THREADLOCAL int desReadOnly;
+THREADLOCAL int desVar;
+THREADLOCAL int desRoot;
+THREADLOCAL int desDeref;
+THREADLOCAL int vecHelpers;
+THREADLOCAL int divHelpers;
+THREADLOCAL long helperPos;
+THREADLOCAL int openArrayAllowed;
+THREADLOCAL int relVar;
+THREADLOCAL int callCount;
+THREADLOCAL long relBound;
+THREADLOCAL int relOpen;
+THREADLOCAL int lenOpen;
+THREADLOCAL int lenPredOpen;
+
+THREADLOCAL char curProcName[MAXIDLEN];
+THREADLOCAL char curOneArg[MAXTYPELEN * 2 + MAXIDLEN * 4];
+THREADLOCAL char curRetPrefix[MAXTYPELEN];
+THREADLOCAL char curRetSuffix[MAXTYPELEN];
+THREADLOCAL char curParamPrefix[MAXTYPELEN];
+THREADLOCAL char curParamSuffix[MAXTYPELEN];
+THREADLOCAL char curParamId[MAXIDLEN];
+
+THREADLOCAL char desMName[MAXIDLEN];
+THREADLOCAL char desName[MAXIDLEN];
+THREADLOCAL char desQualName[MAXIDLEN * 2 + 1];
+THREADLOCAL char basicTypeModName[MAXIDLEN];
+THREADLOCAL char basicTypeName[MAXIDLEN * 2 + 1];
+THREADLOCAL char varDeclId[MAXIDLEN];
+THREADLOCAL char varDeclPrefix[MAXTYPELEN];
+THREADLOCAL char varDeclSuffix[MAXTYPELEN];
+THREADLOCAL char varDeclBuf[MAXTYPELEN + MAXIDLEN * 2];
+THREADLOCAL char constDeclName[MAXIDLEN];
+THREADLOCAL char typeDeclName[MAXIDLEN];
+THREADLOCAL char typeDeclCName[MAXIDLEN * 2 + 1];
+THREADLOCAL char typeDeclPrefix[MAXTYPELEN];
+THREADLOCAL char typeDeclSuffix[MAXTYPELEN];
+
+THREADLOCAL int *symbolTable = NULL;
+THREADLOCAL int *symbolTableType = NULL;
+THREADLOCAL int *symbolTableId = NULL;
+THREADLOCAL int *symbolTableDataType = NULL;
+THREADLOCAL int *symbolTableLevel = NULL;
+THREADLOCAL int *symbolTableNext = NULL;
+THREADLOCAL long *symbolTableIntValue = NULL;
+THREADLOCAL double *symbolTableRealValue = NULL;
+THREADLOCAL int *symbolTableHash = NULL;
+THREADLOCAL int *symbolTableFact = NULL;
+THREADLOCAL int symbolTableCapacity = 0;
+THREADLOCAL int symbolTableHashSize = 0;
+THREADLOCAL int symbolTableScopeLevel;
+
+THREADLOCAL int *typeForm = NULL;
+THREADLOCAL int *typeBase = NULL;
+THREADLOCAL int *typeLen = NULL;
+THREADLOCAL int typesPtr = 10;
+THREADLOCAL int typeTableCapacity = 0;
+
+THREADLOCAL char *fieldNames = NULL;
+THREADLOCAL int fieldNamesLen;
+THREADLOCAL int fieldNamesCapacity = 0;
+THREADLOCAL int *fieldType = NULL;
+THREADLOCAL int *fieldName = NULL;
+THREADLOCAL int *fieldDecl = NULL;
+THREADLOCAL int *fieldMark = NULL;
+THREADLOCAL int *fieldOrder = NULL;
+THREADLOCAL int fieldCount;
+THREADLOCAL int fieldCapacity = 0;
+THREADLOCAL int recordCount;
+THREADLOCAL long layoutHotEnd;
+
+THREADLOCAL int *irKind = NULL;
+THREADLOCAL long *irStart = NULL;
+THREADLOCAL long *irEnd = NULL;
+THREADLOCAL int *irValue = NULL;
+THREADLOCAL int *irLine = NULL;
+THREADLOCAL int *irBranch = NULL;
+THREADLOCAL int irCount;
+THREADLOCAL int irCapacity = 0;
+THREADLOCAL long irPending;
+THREADLOCAL int irPendingLine;
+
+THREADLOCAL int *branchLine = NULL;
+THREADLOCAL int *branchMulti = NULL;
+THREADLOCAL int branchCount;
+THREADLOCAL int branchCapacity = 0;
+
+THREADLOCAL char *profileData = NULL;
+THREADLOCAL double profileMaxCalls;
+THREADLOCAL double *profileTotal = NULL;
+THREADLOCAL double *profileTaken = NULL;
+THREADLOCAL int profileBranches;
+THREADLOCAL int profileCapacity = 0;
+THREADLOCAL int profileMatched;
+THREADLOCAL unsigned long moduleHash;
+
+THREADLOCAL int lineMapped;
+THREADLOCAL int lineSource;
+THREADLOCAL long lineOutput;
+THREADLOCAL long lineCount;
+THREADLOCAL long lineCountPos;
+
+THREADLOCAL int *guardLen = NULL;
+THREADLOCAL int *guardLine = NULL;
+THREADLOCAL int *guardState = NULL;
+THREADLOCAL int *guardLoop = NULL;
+THREADLOCAL int guardCount;
+THREADLOCAL int guardCapacity = 0;
+
+THREADLOCAL int *loopVar = NULL;
+THREADLOCAL long *loopBound = NULL;
+THREADLOCAL int *loopOpen = NULL;
+THREADLOCAL int *loopMods = NULL;
+THREADLOCAL int *loopLowSafe = NULL;
+THREADLOCAL int *loopFirstGuard = NULL;
+THREADLOCAL int *loopFloorSaved = NULL;
+THREADLOCAL int *loopCaseDepth = NULL;
+THREADLOCAL int *loopExit = NULL;
+THREADLOCAL int *loopFor = NULL;
+THREADLOCAL int *loopCounter = NULL;
+THREADLOCAL int loopCount;
+THREADLOCAL int loopCapacity = 0;
+THREADLOCAL int loopFloor;
+THREADLOCAL int blockDepth;
+THREADLOCAL int localStart;
+THREADLOCAL int exitCount;
+THREADLOCAL int forCount;
+
+THREADLOCAL long *caseLow = NULL;
+THREADLOCAL long *caseHigh = NULL;
+THREADLOCAL int *caseArm = NULL;
+THREADLOCAL int *caseOf = NULL;
+THREADLOCAL int caseLabelCount;
+THREADLOCAL int caseLabelCapacity = 0;
+THREADLOCAL int *caseFirst = NULL;
+THREADLOCAL int *caseEnd = NULL;
+THREADLOCAL int *caseForm = NULL;
+THREADLOCAL int *caseBreak = NULL;
+THREADLOCAL int caseCount;
+THREADLOCAL int caseCapacity = 0;
+THREADLOCAL int caseDepth;
+THREADLOCAL int caseInner;
+
+THREADLOCAL long checkedStart[MAXCHECKED];
+THREADLOCAL long checkedEnd[MAXCHECKED];
+THREADLOCAL int checkedLen[MAXCHECKED];
+THREADLOCAL int checkedGuard[MAXCHECKED];
+THREADLOCAL int checkedCount;
+THREADLOCAL int hoistAllowed;
+THREADLOCAL int condRegion;
+
+THREADLOCAL int *symTypeMap = NULL;
+THREADLOCAL int *symTypeOrder = NULL;
+THREADLOCAL int symTypeCount;
+
+THREADLOCAL int *importIds = NULL;
+THREADLOCAL int importCount;
+THREADLOCAL int importCapacity = 0;
+
+THREADLOCAL char **depFile = NULL;
+THREADLOCAL char **depModule = NULL;
+THREADLOCAL int *depImportStart = NULL;
+THREADLOCAL int *depImportCount = NULL;
+THREADLOCAL int *depState = NULL;
+THREADLOCAL int *depOrder = NULL;
+THREADLOCAL int *depStack = NULL;
+THREADLOCAL char **depImports = NULL;
+THREADLOCAL int *depImportModule = NULL;
+THREADLOCAL int depCount, depImportTotal, depImportCapacity, depOrderCount, depStackPtr;
+THREADLOCAL char *symData = NULL;
+THREADLOCAL char *symPtr;
+THREADLOCAL char *symEnd;
+
+THREADLOCAL int symbolTableFoundIndex, symbolTableFoundId, symbolTableFoundType;
+THREADLOCAL char *symbolTableFoundName;
 
-FILE *fileIn = NULL;
-FILE *fileC = NULL;
-FILE *fileHeader = NULL;
-
-char *captureBuffer = NULL;
-
-int currentLine = 1;
-int currentChar;
-int currentSymbol = 0;
-char currentToken[MAXIDLEN];
-char moduleName[MAXIDLEN];
-
-char sourceFileName[MAXFNAMELEN];
-char outputNameC[MAXFNAMELEN];
-char outputNameHeader[MAXFNAMELEN];
-
-int isGlobalDefinition;
-
-char curProcName[MAXIDLEN];
-char curArgList[4096];
-char curOneArg[MAXTYPELEN + MAXIDLEN * 2];
-char curRetPrefix[MAXTYPELEN];
-char curRetSuffix[MAXTYPELEN];
-char curParamPrefix[MAXTYPELEN];
-char curParamSuffix[MAXTYPELEN];
-char curParamId[MAXIDLEN];
-
-char desMName[MAXIDLEN];
-char desName[MAXIDLEN];
-char stmtLhsBuffer[2048];
-char basicTypeModName[MAXIDLEN];
-char basicTypeName[MAXIDLEN * 2 + 1];
-char varDeclId[MAXIDLEN];
-char varDeclPrefix[MAXTYPELEN];
-char varDeclSuffix[MAXTYPELEN];
-char varDeclBuf[MAXTYPELEN + MAXIDLEN * 2];
-char constDeclName[MAXIDLEN];
-char arrSizeBuf[MAXIDLEN];
-
-int symbolTable[STABSIZE];
-int symbolTableType[STABSIZE];
-int symbolTableId[STABSIZE];
-int symbolTableDataType[STABSIZE];
-
-int typeForm[STABSIZE];
-int typeBase[STABSIZE];
-int typeLen[STABSIZE];
-int typesPtr = 10;
-
-int symbolTableFoundIndex, symbolTableFoundId, symbolTableFoundType;
-char *symbolTableFoundName;
-
-int symbolTablePtr;
-char symbolTableNameBuffer[STABBUFSIZE];
-int symbolTableNameBufferPtr;
+THREADLOCAL int symbolTablePtr;
+THREADLOCAL char *symbolTableNameBuffer = NULL;
+THREADLOCAL int symbolTableNameBufferPtr;
+THREADLOCAL int symbolTableNameBufferSize = 0;
+
+#ifdef HAVEFORK
+THREADLOCAL char **symCacheName = NULL;
+THREADLOCAL char **symCacheData = NULL;
+THREADLOCAL unsigned long *symCacheHash = NULL;
+THREADLOCAL long *symCacheSize = NULL;
+THREADLOCAL double *symCacheTime = NULL;
+THREADLOCAL long **symCacheTable = NULL;
+THREADLOCAL char **symCacheText = NULL;
+THREADLOCAL double **symCacheReal = NULL;
+THREADLOCAL int symCacheSlot = -1;
+THREADLOCAL int symCacheCount = 0;
+THREADLOCAL int symCacheCapacity = 0;
+#endif
+
+#ifdef SOBTLIB
+THREADLOCAL char **libSymName = NULL;
+THREADLOCAL char **libSymData = NULL;
+THREADLOCAL long *libSymSize = NULL;
+THREADLOCAL int libSymCount = 0;
+THREADLOCAL int libSymCapacity = 0;
+#endif
+
+THREADLOCAL int statsMode = 0;
+THREADLOCAL int statsModules = 0;
+THREADLOCAL long statsTokens, statsLookups, statsProbes;
+THREADLOCAL int statsSymbols;
+THREADLOCAL double statsStart, statsLex, statsEmit, statsTimer;
+THREADLOCAL long statsAlloc;
+THREADLOCAL double statsTotal[STATCOUNT];
+const char *statsNames[STATCOUNT] = {
+    "lines", "tokens", "lex_s", "parse_s", "emit_s", "total_s", "lookups", "probes",
+    "symbols", "types", "c_bytes", "h_bytes", "allocated"
+};
 
 void nextToken(void);
 int parseExpression(void);
@@ -159,20 +495,46 @@ int parseType(char *prefix, char *suffix);
 int parseDesignator(void);
 int parseBasicType(char *prefix, char *suffix);
 int parseSimpleExpression(void);
+unsigned long hashBytes(unsigned long h, const char *s, long len);
+char *copyString(const char *s, int len);
+long typeSize(int t);
+void noteAssignment(int v, int kind);
+void forgetGlobals(void);
+
+void bufferAppend(int b, const char *s);
 
 void cleanupFiles(void) {
-    if (fileC) fclose(fileC);
-    if (fileHeader) fclose(fileHeader);
-    if (fileIn) fclose(fileIn);
-    fileC = fileHeader = fileIn = NULL;
+    if (sourceBuffer) free(sourceBuffer);
+    sourceBuffer = NULL;
+    if (symData) free(symData);
+    symData = NULL;
 }
 
-void fatalError(const char *msg) {
-    printf("%s:%d: %s\n", sourceFileName, currentLine, msg);
+void diagnostic(const char *fmt, ...) {
+    char buf[MAXFNAMELEN * 4];
+    va_list args;
+    va_start(args, fmt);
+    vsprintf(buf, fmt, args);
+    va_end(args);
+    if (diagToBuffer) bufferAppend(BUFDIAG, buf);
+    else fputs(buf, stdout);
+}
+
+void stopTranslation(void) {
     cleanupFiles();
+    if (errorJump) longjmp(translationAbort, 1);
+    exit(1);
+}
+
+void fatalError(const char *msg) {
+    diagnostic("%s:%d: %s\n", sourceFileName, currentLine, msg);
+#ifndef SOBTLIB
     remove(outputNameC);
     remove(outputNameHeader);
-    exit(1);
+    remove(outputNameSym);
+    if (incrementalMode) remove(outputNameCache);
+#endif
+    stopTranslation();
 }
 
 void matchSymbol(int s, const char *msg) {
@@ -188,14 +550,228 @@ int checkLexeme(int s) {
     return 0;
 }
 
+void bufferReset(int b) {
+    if (bufferSize[b] == 0) {
+        bufferData[b] = (char *)malloc(BUFINITSIZE);
+        if (bufferData[b] == NULL) fatalError("Out of memory");
+        bufferSize[b] = BUFINITSIZE;
+    }
+    bufferLen[b] = 0;
+    bufferData[b][0] = 0;
+}
+
+void bufferAppendRange(int b, const char *s, long len) {
+    long size = bufferSize[b];
+    char *data;
+    if (bufferLen[b] + len + 1 > size) {
+        while (bufferLen[b] + len + 1 > size) size *= 2;
+        data = (char *)realloc(bufferData[b], size);
+        if (data == NULL) fatalError("Out of memory");
+        bufferData[b] = data;
+        bufferSize[b] = size;
+    }
+    memcpy(bufferData[b] + bufferLen[b], s, len);
+    bufferLen[b] += len;
+    bufferData[b][bufferLen[b]] = 0;
+}
+
+void bufferAppend(int b, const char *s) {
+    bufferAppendRange(b, s, (long)strlen(s));
+}
+
+int fileHasContent(const char *fileName, const char *mode, const char *data, long len) {
+    char block[512];
+    FILE *f = fopen(fileName, mode);
+    long n, pos = 0;
+    if (!f) return 0;
+    while ((n = (long)fread(block, 1, sizeof(block), f)) > 0) {
+        if (pos + n > len || memcmp(block, data + pos, n) != 0) {
+            fclose(f);
+            return 0;
+        }
+        pos += n;
+    }
+    fclose(f);
+    return pos == len;
+}
+
+int bufferFlush(int b, const char *fileName, int binary) {
+    char tempName[MAXFNAMELEN + 8];
+    FILE *f;
+    int ok;
+    if (incrementalMode && fileHasContent(fileName, binary ? "rb" : "r", bufferData[b], bufferLen[b])) return 0;
+    sprintf(tempName, "%s.tmp", fileName);
+    f = fopen(tempName, binary ? "wb" : "w");
+    if (!f) fatalError("Cannot create output files");
+    ok = (long)fwrite(bufferData[b], 1, bufferLen[b], f) == bufferLen[b];
+    if (fclose(f) != 0) ok = 0;
+    if (ok) {
+#ifndef HAVEFORK
+        remove(fileName);
+#endif
+        ok = rename(tempName, fileName) == 0;
+    }
+    if (!ok) {
+        remove(tempName);
+        fatalError("Cannot write output files");
+    }
+    return 1;
+}
+
+void bufferAppendInt(int b, long v) {
+    char bytes[4];
+    bytes[0] = (char)(v & 0xFF);
+    bytes[1] = (char)((v >> 8) & 0xFF);
+    bytes[2] = (char)((v >> 16) & 0xFF);
+    bytes[3] = (char)((v >> 24) & 0xFF);
+    bufferAppendRange(b, bytes, 4);
+}
+
 void emitCode(const char *s) {
-    if (captureBuffer != NULL) {
-        strcat(captureBuffer, s);
+    bufferAppend(emitBuffer, s);
+}
+
+void emitCodeRange(const char *s, int len) {
+    bufferAppendRange(emitBuffer, s, len);
+}
+
+void lineFileName(int b, const char *s) {
+    char c[2];
+    c[1] = 0;
+    bufferAppend(b, "\"");
+    while (*s) {
+        if (*s == '\\' || *s == '"') bufferAppend(b, "\\");
+        c[0] = *s++;
+        bufferAppend(b, c);
+    }
+    bufferAppend(b, "\"");
+}
+
+long lineNext(void) {
+    if (bufferLen[BUFC] > 0 && bufferData[BUFC][bufferLen[BUFC] - 1] != '\n') bufferAppend(BUFC, "\n");
+    while (lineCountPos < bufferLen[BUFC]) {
+        if (bufferData[BUFC][lineCountPos] == '\n') lineCount++;
+        lineCountPos++;
+    }
+    return lineCount + 1;
+}
+
+void lineDirective(int line) {
+    char buf[32];
+    long next = lineNext();
+    if (line <= 0 || (lineMapped && lineSource + (next - lineOutput) == line)) return;
+    sprintf(buf, "#line %d", line);
+    bufferAppend(BUFC, buf);
+    if (!lineMapped) {
+        bufferAppend(BUFC, " ");
+        lineFileName(BUFC, sourceFileName);
+    }
+    bufferAppend(BUFC, "\n");
+    lineMapped = 1;
+    lineSource = line;
+    lineOutput = next + 1;
+}
+
+void lineRestore(void) {
+    char buf[32];
+    long next;
+    if (!lineMapped) return;
+    next = lineNext();
+    sprintf(buf, "#line %ld ", next + 1);
+    bufferAppend(BUFC, buf);
+    lineFileName(BUFC, outputNameC);
+    bufferAppend(BUFC, "\n");
+    lineMapped = 0;
+}
+
+void lineCopy(const char *p, int line, int each) {
+    const char *q;
+    long len;
+    int first = 1;
+    while (*p) {
+        q = strchr(p, '\n');
+        len = q ? (long)(q - p + 1) : (long)strlen(p);
+        if (*p == '\n') {
+            if (first && !each) line++;
+        } else if (each || first) {
+            lineDirective(line);
+            first = 0;
+        }
+        bufferAppendRange(BUFC, p, len);
+        p += len;
+    }
+}
+
+void bufferDelete(int b, long pos, long len) {
+    memmove(bufferData[b] + pos, bufferData[b] + pos + len, bufferLen[b] - pos - len + 1);
+    bufferLen[b] -= len;
+    if (b == BUFC && lineCountPos > pos) lineCountPos -= len;
+}
+
+void emitInsert(long pos, const char *s) {
+    long len = (long)strlen(s);
+    bufferAppendRange(emitBuffer, s, len);
+    memmove(bufferData[emitBuffer] + pos + len, bufferData[emitBuffer] + pos, bufferLen[emitBuffer] - len - pos);
+    memcpy(bufferData[emitBuffer] + pos, s, len);
+}
+
+void emitTruncate(long pos) {
+    bufferLen[emitBuffer] = pos;
+    bufferData[emitBuffer][pos] = 0;
+}
+
+int numberType(const char *s) {
+    if (s[0] == '0' && s[1] == 'x') return 1;
+    if (strchr(s, '.') || strchr(s, 'E')) return 3;
+    return 1;
+}
+
+void setConstantValue(const char *s, int tid) {
+    exprConst = 1;
+    exprIntVal = 0;
+    exprRealVal = 0;
+    if (*s == '(') s++;
+    if (tid == 3 || tid == 4) {
+        exprRealVal = strtod(s, NULL);
+    } else if (tid == 5) {
+        exprIntVal = strcmp(s, "true") == 0;
+    } else if (s[0] == '\'') {
+        if (s[1] != 0 && s[2] == '\'' && s[3] == 0) exprIntVal = (unsigned char)s[1];
+        else exprConst = 0;
+    } else if (s[0] == '0' && s[1] == 'x') {
+        exprIntVal = (long)strtoul(s + 2, NULL, 16);
+    } else {
+        exprIntVal = strtol(s, NULL, 10);
+    }
+}
+
+void formatConstant(char *buf, int tid) {
+    if (tid == 3 || tid == 4) {
+        sprintf(buf, "%.15g", exprRealVal);
+        if (strtod(buf, NULL) != exprRealVal) sprintf(buf, "%.17g", exprRealVal);
+        if (strpbrk(buf, ".en") == NULL) strcat(buf, ".0");
+    } else if (tid == 5) {
+        strcpy(buf, exprIntVal ? "true" : "false");
+    } else if (tid == 6) {
+        if (exprIntVal >= 32 && exprIntVal < 127 && exprIntVal != '\'' && exprIntVal != '\\') sprintf(buf, "'%c'", (int)exprIntVal);
+        else sprintf(buf, "0x%02lX", exprIntVal & 0xFF);
     } else {
-        fprintf(fileC, "%s", s);
+        sprintf(buf, "%ld", exprIntVal);
+    }
+    if (buf[0] == '-') {
+        memmove(buf + 1, buf, strlen(buf) + 1);
+        buf[0] = '(';
+        strcat(buf, ")");
     }
 }
 
+void emitFolded(long start, int tid) {
+    if (!optimizeMode || !exprConst) return;
+    formatConstant(constValueBuf, tid);
+    emitTruncate(start);
+    emitCode(constValueBuf);
+}
+
 const char* getOperatorString(int t) {
     if (t == TASSIGN) return " = ";
     if (t == TEQ) return " == ";
@@ -214,34 +790,214 @@ const char* getOperatorString(int t) {
     return NULL;
 }
 
+int typesCompatible(int t1, int t2) {
+    if (t1 == 0 || t2 == 0) return 1;
+    if (t1 == t2) return 1;
+    if ((t1 == 1 || t1 == 2) && (t2 == 1 || t2 == 2)) return 1;
+    if ((t1 == 3 || t1 == 4) && (t2 == 3 || t2 == 4)) return 1;
+    if ((typeForm[t1] == 8) && (typeForm[t2] == 0)) return 1;
+    if ((typeForm[t1] == 0) && (typeForm[t2] == 8)) return 1;
+    if ((typeForm[t1] == 8) && (typeForm[t2] == 8)) {
+        return typeBase[t1] == 0 || typeBase[t2] == 0 || typesCompatible(typeBase[t1], typeBase[t2]);
+    }
+    if ((typeForm[t1] == 8) && (typeForm[t2] == 7)) {
+        return typeBase[t1] == 0 || typesCompatible(typeBase[t1], typeBase[t2]);
+    }
+    if ((typeForm[t1] == 7) && (typeForm[t2] == 7)) {
+        return typeLen[t1] == typeLen[t2] && typesCompatible(typeBase[t1], typeBase[t2]);
+    }
+    return 0;
+}
+
 void checkTypeCompatibility(int t1, int t2) {
-    if (t1 == 0 || t2 == 0) return;
-    if (t1 == t2) return;
-    if ((t1 == 1 || t1 == 2) && (t2 == 1 || t2 == 2)) return;
-    if ((t1 == 3 || t1 == 4) && (t2 == 3 || t2 == 4)) return;
-    if ((typeForm[t1] == 8) && (typeForm[t2] == 0)) return;
-    if ((typeForm[t1] == 0) && (typeForm[t2] == 8)) return;
-    printf("%s:%d: Type mismatch: %d != %d\n", sourceFileName, currentLine, t1, t2);
-    cleanupFiles();
-    exit(1);
+    if (typesCompatible(t1, t2)) return;
+    diagnostic("%s:%d: Type mismatch: %d != %d\n", sourceFileName, currentLine, t1, t2);
+    stopTranslation();
+}
+
+void *growArray(void *p, int count, int size) {
+    p = realloc(p, (size_t)count * size);
+    if (p == NULL) fatalError("Out of memory");
+    return p;
+}
+
+double statsNow(void) {
+#ifdef HAVEFORK
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (double)tv.tv_sec + (double)tv.tv_usec / 1e6;
+#else
+    return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+void statsCalibrate(void) {
+    double t, d = 0;
+    int i;
+    for (i = 0; i < 100000; i++) {
+        t = statsNow();
+        d += statsNow() - t;
+    }
+    statsTimer = d / 100000;
+}
+
+long statsAllocated(void) {
+    long m = 0;
+    int i;
+    for (i = 0; i < BUFCOUNT; i++) m += bufferSize[i];
+    m += (long)symbolTableCapacity * (7 * sizeof(int) + sizeof(long) + sizeof(double));
+    m += (long)symbolTableHashSize * sizeof(int) + symbolTableNameBufferSize;
+    m += (long)typeTableCapacity * 3 * sizeof(int);
+    m += (long)fieldCapacity * 5 * sizeof(int) + fieldNamesCapacity;
+    m += (long)irCapacity * (4 * sizeof(int) + 2 * sizeof(long));
+    m += (long)guardCapacity * 4 * sizeof(int);
+    m += (long)loopCapacity * (10 * sizeof(int) + sizeof(long));
+    m += (long)caseLabelCapacity * (2 * sizeof(int) + 2 * sizeof(long)) + (long)caseCapacity * 4 * sizeof(int);
+    m += (long)branchCapacity * 2 * sizeof(int);
+    m += (long)profileCapacity * 2 * sizeof(double);
+    m += (long)profProcCapacity * (4 * sizeof(long) + 3 * sizeof(int));
+    m += (long)importCapacity * sizeof(int);
+    if (sourceBuffer) m += (long)(sourceEnd - sourceBuffer) + 2;
+    if (profileData) m += (long)strlen(profileData) + 1;
+    return m;
+}
+
+void statsPrint(const char *name, const double *v) {
+    char buf[MAXFNAMELEN * 3];
+    int i;
+    sprintf(buf, "stats file=%s", name);
+    for (i = 0; i < STATCOUNT; i++) {
+        sprintf(buf + strlen(buf), i >= STATLEX && i <= STATTIME ? " %s=%.6f" : " %s=%.0f", statsNames[i], v[i]);
+    }
+    sprintf(buf + strlen(buf), " tokens_per_s=%.0f avg_probe=%.2f stabsize=%d\n",
+        v[STATTIME] > 0 ? v[STATTOKENS] / v[STATTIME] : 0.0,
+        v[STATLOOKUPS] > 0 ? v[STATPROBES] / v[STATLOOKUPS] : 0.0, STABSIZE);
+    diagnostic("%s", buf);
+}
+
+void statsAdd(const double *v) {
+    int i;
+    for (i = 0; i < STATCOUNT; i++) {
+        if (i == STATSYMBOLS || i == STATTYPES || i == STATALLOC) {
+            if (v[i] > statsTotal[i]) statsTotal[i] = v[i];
+        } else {
+            statsTotal[i] += v[i];
+        }
+    }
+    statsModules++;
+}
+
+void statsParse(const char *log) {
+    double v[STATCOUNT];
+    char key[MAXIDLEN];
+    const char *p, *q;
+    int i;
+    for (p = strstr(log, "stats file="); p; p = strstr(p + 1, "stats file=")) {
+        if (p != log && p[-1] != '\n') continue;
+        for (i = 0; i < STATCOUNT; i++) {
+            sprintf(key, " %s=", statsNames[i]);
+            q = strstr(p, key);
+            v[i] = q ? atof(q + strlen(key)) : 0;
+        }
+        statsAdd(v);
+    }
+}
+
+void statsModule(int translated) {
+    double v[STATCOUNT];
+    v[STATLINES] = translated ? currentLine : 0;
+    v[STATTOKENS] = (double)statsTokens;
+    v[STATTIME] = statsNow() - statsStart;
+    v[STATLEX] = statsLex > 0 ? statsLex : 0;
+    v[STATEMIT] = statsEmit;
+    v[STATPARSE] = v[STATTIME] - v[STATLEX] - statsEmit;
+    if (v[STATPARSE] < 0) v[STATPARSE] = 0;
+    v[STATLOOKUPS] = (double)statsLookups;
+    v[STATPROBES] = (double)statsProbes;
+    v[STATSYMBOLS] = statsSymbols;
+    v[STATTYPES] = typesPtr;
+    v[STATCBYTES] = (double)bufferLen[BUFC];
+    v[STATHBYTES] = (double)bufferLen[BUFH];
+    v[STATALLOC] = (double)statsAlloc;
+    statsPrint(sourceFileName, v);
+    statsAdd(v);
+}
+
+unsigned symbolTableHashName(const char *name) {
+    unsigned h = 0;
+    while (*name) h = h * 31 + (unsigned char)*name++;
+    return h;
+}
+
+void symbolTableRehash(int size) {
+    int i;
+    unsigned h;
+    symbolTableHash = (int *)growArray(symbolTableHash, size, sizeof(int));
+    symbolTableHashSize = size;
+    for (i = 0; i < size; i++) symbolTableHash[i] = -1;
+    for (i = 0; i < symbolTablePtr; i++) {
+        h = symbolTableHashName(&symbolTableNameBuffer[symbolTable[i]]) & (size - 1);
+        symbolTableNext[i] = symbolTableHash[h];
+        symbolTableHash[h] = i;
+    }
+}
+
+void symbolTableGrow(void) {
+    symbolTableCapacity = symbolTableCapacity ? symbolTableCapacity * 2 : STABSIZE;
+    symbolTable = (int *)growArray(symbolTable, symbolTableCapacity, sizeof(int));
+    symbolTableType = (int *)growArray(symbolTableType, symbolTableCapacity, sizeof(int));
+    symbolTableId = (int *)growArray(symbolTableId, symbolTableCapacity, sizeof(int));
+    symbolTableDataType = (int *)growArray(symbolTableDataType, symbolTableCapacity, sizeof(int));
+    symbolTableLevel = (int *)growArray(symbolTableLevel, symbolTableCapacity, sizeof(int));
+    symbolTableNext = (int *)growArray(symbolTableNext, symbolTableCapacity, sizeof(int));
+    symbolTableFact = (int *)growArray(symbolTableFact, symbolTableCapacity, sizeof(int));
+    symbolTableIntValue = (long *)growArray(symbolTableIntValue, symbolTableCapacity, sizeof(long));
+    symbolTableRealValue = (double *)growArray(symbolTableRealValue, symbolTableCapacity, sizeof(double));
+    if (symbolTableHashSize < symbolTableCapacity) symbolTableRehash(symbolTableCapacity);
+}
+
+void symbolTableReset(void) {
+    symbolTablePtr = 0;
+    symbolTableNameBufferPtr = 0;
+    symbolTableScopeLevel = 0;
+    if (symbolTableCapacity == 0) symbolTableGrow();
+    symbolTableRehash(symbolTableHashSize);
 }
 
 int symbolTableAdd(char *name, int sid, int stype, int dtype) {
-    if (symbolTablePtr >= STABSIZE) fatalError("Symbol table full");
-    if (symbolTableNameBufferPtr + strlen(name) + 1 >= STABBUFSIZE) fatalError("Symbol table name buffer full");
+    int len = (int)strlen(name) + 1;
+    unsigned h;
+    if (symbolTablePtr >= symbolTableCapacity) symbolTableGrow();
+    if (symbolTableNameBufferPtr + len > symbolTableNameBufferSize) {
+        while (symbolTableNameBufferPtr + len > symbolTableNameBufferSize) {
+            symbolTableNameBufferSize = symbolTableNameBufferSize ? symbolTableNameBufferSize * 2 : STABBUFSIZE;
+        }
+        symbolTableNameBuffer = (char *)growArray(symbolTableNameBuffer, symbolTableNameBufferSize, 1);
+    }
     symbolTable[symbolTablePtr] = symbolTableNameBufferPtr;
-    strcpy(&symbolTableNameBuffer[symbolTableNameBufferPtr], name);
-    symbolTableNameBufferPtr += strlen(name) + 1;
+    memcpy(&symbolTableNameBuffer[symbolTableNameBufferPtr], name, len);
+    symbolTableNameBufferPtr += len;
     symbolTableType[symbolTablePtr] = stype;
     symbolTableId[symbolTablePtr] = sid;
     symbolTableDataType[symbolTablePtr] = dtype;
+    symbolTableLevel[symbolTablePtr] = symbolTableScopeLevel;
+    symbolTableIntValue[symbolTablePtr] = 0;
+    symbolTableRealValue[symbolTablePtr] = 0;
+    symbolTableFact[symbolTablePtr] = 0;
+    h = symbolTableHashName(name) & (symbolTableHashSize - 1);
+    symbolTableNext[symbolTablePtr] = symbolTableHash[h];
+    symbolTableHash[h] = symbolTablePtr;
     symbolTablePtr++;
+    if (symbolTablePtr > statsSymbols) statsSymbols = symbolTablePtr;
     return symbolTablePtr - 1;
 }
 
 int symbolTableFind(char *name) {
     int i;
-    for (i = symbolTablePtr - 1; i >= 0; i--) {
+    statsLookups++;
+    i = symbolTableHash[symbolTableHashName(name) & (symbolTableHashSize - 1)];
+    while (i >= 0) {
+        statsProbes++;
         if (strcmp(&symbolTableNameBuffer[symbolTable[i]], name) == 0) {
             symbolTableFoundName = &symbolTableNameBuffer[symbolTable[i]];
             symbolTableFoundId = symbolTableId[i];
@@ -249,13 +1005,266 @@ int symbolTableFind(char *name) {
             symbolTableFoundIndex = i;
             return 1;
         }
+        i = symbolTableNext[i];
+    }
+    symbolTableFoundName = NULL;
+    symbolTableFoundId = 0;
+    symbolTableFoundType = 0;
+    symbolTableFoundIndex = 0;
+    return 0;
+}
+
+int symbolTableFindInScope(char *name) {
+    return symbolTableFind(name) && symbolTableLevel[symbolTableFoundIndex] == symbolTableScopeLevel;
+}
+
+void symbolTableOpenScope(void) {
+    symbolTableScopeLevel++;
+}
+
+void symbolTableCloseScope(void) {
+    unsigned h;
+    while (symbolTablePtr > 0 && symbolTableLevel[symbolTablePtr - 1] == symbolTableScopeLevel) {
+        symbolTablePtr--;
+        h = symbolTableHashName(&symbolTableNameBuffer[symbolTable[symbolTablePtr]]) & (symbolTableHashSize - 1);
+        symbolTableHash[h] = symbolTableNext[symbolTablePtr];
+        symbolTableNameBufferPtr = symbolTable[symbolTablePtr];
+    }
+    symbolTableScopeLevel--;
+}
+
+int typeTableAdd(int form, int base, int len) {
+    if (typesPtr >= typeTableCapacity) {
+        typeTableCapacity = typeTableCapacity ? typeTableCapacity * 2 : STABSIZE;
+        typeForm = (int *)growArray(typeForm, typeTableCapacity, sizeof(int));
+        typeBase = (int *)growArray(typeBase, typeTableCapacity, sizeof(int));
+        typeLen = (int *)growArray(typeLen, typeTableCapacity, sizeof(int));
+    }
+    typeForm[typesPtr] = form;
+    typeBase[typesPtr] = base;
+    typeLen[typesPtr] = len;
+    return typesPtr++;
+}
+
+int fieldNameAdd(const char *s, int len) {
+    int pos = fieldNamesLen;
+    if (fieldNamesLen + len + 1 > fieldNamesCapacity) {
+        while (fieldNamesLen + len + 1 > fieldNamesCapacity) {
+            fieldNamesCapacity = fieldNamesCapacity ? fieldNamesCapacity * 2 : STABBUFSIZE;
+        }
+        fieldNames = (char *)growArray(fieldNames, fieldNamesCapacity, 1);
+    }
+    memcpy(&fieldNames[pos], s, len);
+    fieldNames[pos + len] = 0;
+    fieldNamesLen += len + 1;
+    return pos;
+}
+
+long typeAlign(int t) {
+    long a, m = 1;
+    int i;
+    if (t == 9) return sizeof(void (*)(void));
+    if (typeForm[t] == 7) return typeAlign(typeBase[t]);
+    if (typeForm[t] == 12) {
+        for (i = 1; i <= typeLen[t]; i++) {
+            a = typeAlign(typeBase[t + i]);
+            if (a > m) m = a;
+        }
+        return m;
+    }
+    a = typeSize(t);
+    return a > 0 ? a : 1;
+}
+
+long typeSize(int t) {
+    long size = 0, s, a;
+    int i;
+    if (t == 9) return sizeof(void (*)(void));
+    switch (typeForm[t]) {
+    case 1: return sizeof(int);
+    case 2: return sizeof(long);
+    case 3: return sizeof(float);
+    case 4: return sizeof(double);
+    case 5: return 1;
+    case 6: return 1;
+    case 7: return typeLen[t] * typeSize(typeBase[t]);
+    case 8: return sizeof(void *);
+    case 12:
+        for (i = 1; i <= typeLen[t]; i++) {
+            s = typeSize(typeBase[t + i]);
+            if (s == 0) return 0;
+            a = typeAlign(typeBase[t + i]);
+            size = (size + a - 1) / a * a + s;
+        }
+        a = typeAlign(t);
+        return (size + a - 1) / a * a;
+    }
+    return 0;
+}
+
+int fieldFind(int rec, const char *name) {
+    int i;
+    for (i = rec + 1; i <= rec + typeLen[rec]; i++) {
+        if (strcmp(&fieldNames[typeLen[i]], name) == 0) return i;
     }
     return 0;
 }
 
-void formatHex(int i) {
+int keywordFind(const char *s, int len) {
+    switch (len) {
+    case 2:
+        if (s[0] == 'I' && s[1] == 'F') return TIF;
+        if (s[0] == 'D' && s[1] == 'O') return TDO;
+        if (s[0] == 'O' && s[1] == 'F') return TOF;
+        if (s[0] == 'O' && s[1] == 'R') return TOR;
+        if (s[0] == 'T' && s[1] == 'O') return TTO;
+        if (s[0] == 'B' && s[1] == 'Y') return TBY;
+        break;
+    case 3:
+        switch (s[0]) {
+        case 'A':
+            if (strcmp(s, "ABS") == 0) return TFABS;
+            if (strcmp(s, "ASH") == 0) return TFASH;
+            break;
+        case 'C':
+            if (strcmp(s, "CHR") == 0) return TFCHR;
+            break;
+        case 'D':
+            if (strcmp(s, "DEC") == 0) return TDEC;
+            if (strcmp(s, "DIV") == 0) return TDIV;
+            break;
+        case 'E':
+            if (strcmp(s, "END") == 0) return TEND;
+            break;
+        case 'F':
+            if (strcmp(s, "FOR") == 0) return TFOR;
+            break;
+        case 'I':
+            if (strcmp(s, "INC") == 0) return TINC;
+            break;
+        case 'L':
+            if (strcmp(s, "LEN") == 0) return TFLEN;
+            break;
+        case 'M':
+            if (strcmp(s, "MOD") == 0) return TMOD;
+            break;
+        case 'N':
+            if (strcmp(s, "NIL") == 0) return TNIL;
+            break;
+        case 'O':
+            if (strcmp(s, "ODD") == 0) return TFODD;
+            if (strcmp(s, "ORD") == 0) return TFORD;
+            break;
+        case 'V':
+            if (strcmp(s, "VAR") == 0) return TVAR;
+            break;
+        }
+        break;
+    case 4:
+        switch (s[0]) {
+        case 'C':
+            if (strcmp(s, "CASE") == 0) return TCASE;
+            if (strcmp(s, "CHAR") == 0) return TTYPECHAR;
+            break;
+        case 'E':
+            if (strcmp(s, "ELSE") == 0) return TELSE;
+            break;
+        case 'F':
+            if (strcmp(s, "FILL") == 0) return TFILL;
+            break;
+        case 'R':
+            if (strcmp(s, "REAL") == 0) return TTYPEREAL;
+            break;
+        case 'T':
+            if (strcmp(s, "THEN") == 0) return TTHEN;
+            if (strcmp(s, "TRUE") == 0) return TTRUE;
+            if (strcmp(s, "TYPE") == 0) return TTYPE;
+            break;
+        case 'V':
+            if (strcmp(s, "VADD") == 0) return TVADD;
+            if (strcmp(s, "VDOT") == 0) return TFVDOT;
+            if (strcmp(s, "VSUM") == 0) return TFVSUM;
+            break;
+        }
+        break;
+    case 5:
+        switch (s[0]) {
+        case 'A':
+            if (strcmp(s, "ARRAY") == 0) return TARRAY;
+            break;
+        case 'B':
+            if (strcmp(s, "BEGIN") == 0) return TBEGIN;
+            if (strcmp(s, "BREAK") == 0) return TBREAK;
+            break;
+        case 'C':
+            if (strcmp(s, "CONST") == 0) return TCONST;
+            break;
+        case 'E':
+            if (strcmp(s, "ELSIF") == 0) return TELSIF;
+            break;
+        case 'F':
+            if (strcmp(s, "FALSE") == 0) return TFALSE;
+            if (strcmp(s, "FLOOR") == 0) return TFFLOOR;
+            break;
+        case 'U':
+            if (strcmp(s, "UNTIL") == 0) return TUNTIL;
+            break;
+        case 'W':
+            if (strcmp(s, "WHILE") == 0) return TWHILE;
+            break;
+        }
+        break;
+    case 6:
+        switch (s[0]) {
+        case 'A':
+            if (strcmp(s, "ASSERT") == 0) return TFASSERT;
+            break;
+        case 'I':
+            if (strcmp(s, "IMPORT") == 0) return TIMPORT;
+            break;
+        case 'M':
+            if (strcmp(s, "MODULE") == 0) return TMODULE;
+            break;
+        case 'R':
+            if (strcmp(s, "RECORD") == 0) return TRECORD;
+            if (strcmp(s, "REPEAT") == 0) return TREPEAT;
+            if (strcmp(s, "RETURN") == 0) return TRETURN;
+            break;
+        case 'V':
+            if (strcmp(s, "VSCALE") == 0) return TVSCALE;
+            break;
+        }
+        break;
+    case 7:
+        switch (s[0]) {
+        case 'B':
+            if (strcmp(s, "BOOLEAN") == 0) return TTYPEBOOL;
+            break;
+        case 'I':
+            if (strcmp(s, "INTEGER") == 0) return TTYPEINT;
+            break;
+        case 'L':
+            if (strcmp(s, "LONGINT") == 0) return TTYPELONG;
+            break;
+        case 'P':
+            if (strcmp(s, "POINTER") == 0) return TPOINTER;
+            break;
+        }
+        break;
+    case 8:
+        if (strcmp(s, "CONTINUE") == 0) return TCONT;
+        if (strcmp(s, "LONGREAL") == 0) return TTYPEDBL;
+        break;
+    case 9:
+        if (strcmp(s, "PROCEDURE") == 0) return TPROC;
+        break;
+    }
+    return TIDENT;
+}
+
+void formatHex(char *p, int i) {
     int k;
-    currentChar = fgetc(fileIn);
+    sourcePtr = p + 1;
     currentToken[i] = 0;
     if (i > MAXIDLEN - 3) i = MAXIDLEN - 3;
     for (k = i; k >= 0; k--) currentToken[k + 2] = currentToken[k];
@@ -263,195 +1272,220 @@ void formatHex(int i) {
     currentToken[1] = 'x';
 }
 
-void nextToken(void) {
-    int i = 0, q = 0, level = 0;
-    while (isspace(currentChar)) {
-        if (currentChar == '\n') currentLine++;
-        currentChar = fgetc(fileIn);
+void bufferAppendSource(int b, const char *s, const char *end) {
+    const char *q;
+    while (s < end) {
+        q = s;
+        while (q < end && !(q[0] == '\r' && q + 1 < end && q[1] == '\n')) q++;
+        bufferAppendRange(b, s, (long)(q - s));
+        s = q + 1;
+    }
+}
+
+void skipComment(void) {
+    char *p = sourcePtr + 2;
+    char *start;
+    int level = 1, line = currentLine;
+    if (*p == '{' || *p == '#') {
+        start = p + 1;
+        while (p < sourceEnd && !(p[0] == '*' && p[1] == ')')) {
+            if (*p == '\n') currentLine++;
+            p++;
+        }
+        if (*(start - 1) == '{') {
+            if (linesMode && emitBuffer == BUFC) lineDirective(line);
+            if (emitBuffer == BUFIR && bufferLen[BUFIR] == irPending) irPendingLine = line;
+            bufferAppendSource(emitBuffer, start, p);
+            emitCode("\n");
+            if (linesMode && emitBuffer == BUFC) lineRestore();
+        } else {
+            bufferAppendSource(BUFH, start, p);
+            bufferAppend(BUFH, "\n");
+            headerDirectives++;
+        }
+        if (p < sourceEnd) p += 2;
+    } else {
+        while (level > 0 && p < sourceEnd) {
+            if (*p == '\n') {
+                currentLine++;
+                p++;
+            } else if (p[0] == '(' && p[1] == '*') {
+                level++;
+                p += 2;
+            } else if (p[0] == '*' && p[1] == ')') {
+                level--;
+                p += 2;
+            } else {
+                p++;
+            }
+        }
+    }
+    sourcePtr = p;
+}
+
+void scanToken(void) {
+    int i = 0, q = 0;
+    char *p;
+    while (1) {
+        p = sourcePtr;
+        while (isspace((unsigned char)*p)) {
+            if (*p == '\n') currentLine++;
+            p++;
+        }
+        sourcePtr = p;
+        if (p[0] != '(' || p[1] != '*') break;
+        skipComment();
     }
-    if (currentChar == EOF) {
+    if (p >= sourceEnd) {
         currentSymbol = TEOF;
         return;
     }
-    if (isalpha(currentChar)) {
+    if (isalpha((unsigned char)*p)) {
         i = 0;
-        while (isalnum(currentChar)) {
-            if (i < MAXIDLEN - 1) currentToken[i++] = (char)currentChar;
-            currentChar = fgetc(fileIn);
+        while (isalnum((unsigned char)*p)) {
+            if (i < MAXIDLEN - 1) currentToken[i++] = *p;
+            p++;
         }
+        sourcePtr = p;
         currentToken[i] = 0;
-        currentSymbol = TIDENT;
-        if (symbolTableFind(currentToken)) {
-            if (symbolTableFoundType < 200) {
-                currentSymbol = symbolTableFoundType;
-                if (currentSymbol == TTRUE) {
-                    currentSymbol = TNUMBER;
-                    strcpy(currentToken, "true");
-                } else if (currentSymbol == TFALSE) {
-                    currentSymbol = TNUMBER;
-                    strcpy(currentToken, "false");
-                } else if (currentSymbol == TNIL) {
-                    currentSymbol = TNUMBER;
-                    strcpy(currentToken, "NULL");
-                }
-            }
-        }
+        currentSymbol = keywordFind(currentToken, i);
+        if (currentSymbol == TIDENT) symbolTableFind(currentToken);
         return;
     }
-    if (isdigit(currentChar)) {
+    if (isdigit((unsigned char)*p)) {
         i = 0;
-        while (isxdigit(currentChar)) {
-            if (i < MAXIDLEN - 1) currentToken[i++] = (char)currentChar;
-            currentChar = fgetc(fileIn);
+        while (isxdigit((unsigned char)*p)) {
+            if (i < MAXIDLEN - 1) currentToken[i++] = *p;
+            p++;
         }
-        if (currentChar == 'H') {
-            formatHex(i);
+        if (*p == 'H') {
+            formatHex(p, i);
             currentSymbol = TNUMBER;
             return;
         }
-        else if (currentChar == 'X') {
-            formatHex(i);
+        else if (*p == 'X') {
+            formatHex(p, i);
             currentSymbol = TCHAR;
             return;
         }
-        else if (currentChar == '.') {
-            if (i < MAXIDLEN - 1) currentToken[i++] = (char)currentChar;
-            currentChar = fgetc(fileIn);
-            while (isdigit(currentChar)) {
-                if (i < MAXIDLEN - 1) currentToken[i++] = (char)currentChar;
-                currentChar = fgetc(fileIn);
+        else if (*p == '.' && p[1] != '.') {
+            if (i < MAXIDLEN - 1) currentToken[i++] = *p;
+            p++;
+            while (isdigit((unsigned char)*p)) {
+                if (i < MAXIDLEN - 1) currentToken[i++] = *p;
+                p++;
             }
-            if (currentChar == 'E' || currentChar == 'e') {
-                if (i < MAXIDLEN - 1) currentToken[i++] = (char)currentChar;
-                currentChar = fgetc(fileIn);
-                if (currentChar == '+' || currentChar == '-') {
-                    if (i < MAXIDLEN - 1) currentToken[i++] = (char)currentChar;
-                    currentChar = fgetc(fileIn);
+            if (*p == 'E' || *p == 'e') {
+                if (i < MAXIDLEN - 1) currentToken[i++] = *p;
+                p++;
+                if (*p == '+' || *p == '-') {
+                    if (i < MAXIDLEN - 1) currentToken[i++] = *p;
+                    p++;
                 }
-                if (!isdigit(currentChar)) {
-                    printf("Lexer error: Digit expected after exponent\n");
-                    cleanupFiles();
-                    exit(1);
+                if (!isdigit((unsigned char)*p)) {
+                    diagnostic("Lexer error: Digit expected after exponent\n");
+                    stopTranslation();
                 }
-                while (isdigit(currentChar)) {
-                    if (i < MAXIDLEN - 1) currentToken[i++] = (char)currentChar;
-                    currentChar = fgetc(fileIn);
+                while (isdigit((unsigned char)*p)) {
+                    if (i < MAXIDLEN - 1) currentToken[i++] = *p;
+                    p++;
                 }
             }
         }
+        sourcePtr = p;
         currentToken[i] = 0;
         currentSymbol = TNUMBER;
         return;
     }
-    if (currentChar == '"' || currentChar == '\'') {
-        q = currentChar;
+    if (*p == '"' || *p == '\'') {
+        q = *p++;
         i = 0;
         currentToken[i++] = (char)q;
-        currentChar = fgetc(fileIn);
-        while (currentChar != q && currentChar != EOF) {
-            if (i < MAXIDLEN - 2) currentToken[i++] = (char)currentChar;
-            currentChar = fgetc(fileIn);
+        while (*p != q && p < sourceEnd) {
+            if (*p == '\n') currentLine++;
+            if (i < MAXIDLEN - 2) currentToken[i++] = *p;
+            p++;
         }
-        if (currentChar == q) currentChar = fgetc(fileIn);
+        if (*p == q) p++;
+        sourcePtr = p;
         currentToken[i++] = (char)q;
         currentToken[i] = '\0';
         currentSymbol = (q == '"') ? TSTRING : TCHAR;
         return;
     }
-    if (currentChar == '(') {
-        currentChar = fgetc(fileIn);
-        if (currentChar == '*') {
-            currentChar = fgetc(fileIn);
-            level = 1;
-            while (level > 0 && currentChar != EOF) {
-                if (currentChar == '(') {
-                    currentChar = fgetc(fileIn);
-                    if (currentChar == '*') {
-                        level++;
-                        currentChar = fgetc(fileIn);
-                    }
-                } else if (currentChar == '*') {
-                    currentChar = fgetc(fileIn);
-                    if (currentChar == ')') {
-                        level--;
-                        currentChar = fgetc(fileIn);
-                    }
-                } else {
-                    currentChar = fgetc(fileIn);
-                }
-            }
-            nextToken();
-            return;
-        }
+    sourcePtr = p + 1;
+    if (*p == '(') {
         currentSymbol = TLPAREN;
-    } else if (currentChar == ')') {
-        currentChar = fgetc(fileIn);
+    } else if (*p == ')') {
         currentSymbol = TRPAREN;
-    } else if (currentChar == '[') {
-        currentChar = fgetc(fileIn);
+    } else if (*p == '[') {
         currentSymbol = TLBRACK;
-    } else if (currentChar == ']') {
-        currentChar = fgetc(fileIn);
+    } else if (*p == ']') {
         currentSymbol = TRBRACK;
-    } else if (currentChar == ';') {
-        currentChar = fgetc(fileIn);
+    } else if (*p == ';') {
         currentSymbol = TSEMICOL;
-    } else if (currentChar == ',') {
-        currentChar = fgetc(fileIn);
+    } else if (*p == ',') {
         currentSymbol = TCOMMA;
-    } else if (currentChar == '.') {
-        currentChar = fgetc(fileIn);
-        currentSymbol = TDOT;
-    } else if (currentChar == '=') {
-        currentChar = fgetc(fileIn);
+    } else if (*p == '.') {
+        if (p[1] == '.') {
+            sourcePtr++;
+            currentSymbol = TUPTO;
+        } else {
+            currentSymbol = TDOT;
+        }
+    } else if (*p == '|') {
+        currentSymbol = TBAR;
+    } else if (*p == '=') {
         currentSymbol = TEQ;
-    } else if (currentChar == '#') {
-        currentChar = fgetc(fileIn);
+    } else if (*p == '#') {
         currentSymbol = TNEQ;
-    } else if (currentChar == '+') {
-        currentChar = fgetc(fileIn);
+    } else if (*p == '+') {
         currentSymbol = TPLUS;
-    } else if (currentChar == '-') {
-        currentChar = fgetc(fileIn);
+    } else if (*p == '-') {
         currentSymbol = TMINUS;
-    } else if (currentChar == '*') {
-        currentChar = fgetc(fileIn);
+    } else if (*p == '*') {
         currentSymbol = TMUL;
-    } else if (currentChar == '&') {
-        currentChar = fgetc(fileIn);
+    } else if (*p == '&') {
         currentSymbol = TAND;
-    } else if (currentChar == '~') {
-        currentChar = fgetc(fileIn);
+    } else if (*p == '~') {
         currentSymbol = TNOT;
-    } else if (currentChar == ':') {
-        currentChar = fgetc(fileIn);
-        if (currentChar == '=') {
-            currentChar = fgetc(fileIn);
+    } else if (*p == ':') {
+        if (p[1] == '=') {
+            sourcePtr++;
             currentSymbol = TASSIGN;
         } else {
             currentSymbol = TCOLON;
         }
-    } else if (currentChar == '<') {
-        currentChar = fgetc(fileIn);
-        if (currentChar == '=') {
-            currentChar = fgetc(fileIn);
+    } else if (*p == '<') {
+        if (p[1] == '=') {
+            sourcePtr++;
             currentSymbol = TLTE;
         } else {
             currentSymbol = TLT;
         }
-    } else if (currentChar == '>') {
-        currentChar = fgetc(fileIn);
-        if (currentChar == '=') {
-            currentChar = fgetc(fileIn);
+    } else if (*p == '>') {
+        if (p[1] == '=') {
+            sourcePtr++;
             currentSymbol = TGTE;
         } else {
             currentSymbol = TGT;
         }
     } else {
-        printf("Lexer error: Unknown char '%c'\n", currentChar);
-        cleanupFiles();
-        exit(1);
+        diagnostic("Lexer error: Unknown char '%c'\n", *p);
+        stopTranslation();
+    }
+}
+
+void nextToken(void) {
+    double t;
+    if (!statsMode || (++statsTokens & (STATSAMPLE - 1)) != 0) {
+        scanToken();
+        return;
     }
+    t = statsNow();
+    scanToken();
+    t = statsNow() - t - statsTimer;
+    if (t < 0.001) statsLex += t * STATSAMPLE;
 }
 
 void consumeIdentifier(char *buf) {
@@ -460,50 +1494,267 @@ void consumeIdentifier(char *buf) {
     matchSymbol(TIDENT, "Identifier expected");
 }
 
-int parseDesignator(void) {
-    int tid = 0;
-    int idxType;
-    strcpy(desMName, moduleName);
-    if(symbolTableFoundType == TSYMAMOD) {
+int isPlainInteger(int i) {
+    if (symbolTableLevel[i] == 0 && symbolTableType[i] != TSYMGVAR && symbolTableType[i] != TSYMGEVAR) return 0;
+    if (symbolTableLevel[i] > 0 && symbolTableType[i] != TSYMGVAR && symbolTableType[i] != TSYMPARAM) return 0;
+    return symbolTableDataType[i] == 1 || symbolTableDataType[i] == 2;
+}
+
+int findChecked(long start, int len) {
+    long n = bufferLen[emitBuffer] - start;
+    int i;
+    for (i = 0; i < checkedCount; i++) {
+        if ((checkedLen[i] == len || (checkedLen[i] > 0 && checkedLen[i] <= len)) && checkedEnd[i] - checkedStart[i] == n
+            && memcmp(bufferData[BUFCHECK] + checkedStart[i], bufferData[emitBuffer] + start, n) == 0) return i;
+    }
+    return -1;
+}
+
+void formatGuard(char *buf, int id) {
+    int len = guardLen[id];
+    if (len > 0) sprintf(buf, ", %d, %d", len, guardLine[id]);
+    else sprintf(buf, ", %s_%s_len, %d", moduleName, &symbolTableNameBuffer[symbolTable[-len - 1]], guardLine[id]);
+}
+
+void hoistCheck(int i) {
+    char buf[MAXIDLEN * 4];
+    if (guardState[checkedGuard[i]] == 1) return;
+    guardState[checkedGuard[i]] = 1;
+    sprintf(buf, "(void)%s_IDX(", moduleName);
+    bufferAppend(BUFHOIST, buf);
+    bufferAppendRange(BUFHOIST, bufferData[BUFCHECK] + checkedStart[i], checkedEnd[i] - checkedStart[i]);
+    formatGuard(buf, checkedGuard[i]);
+    bufferAppend(BUFHOIST, buf);
+    bufferAppend(BUFHOIST, ");\n");
+}
+
+void emitIndexGuard(long start, int len) {
+    int state = 0, top = loopCount - 1, found = -1, k = top;
+    char marker[MAXIDLEN];
+    if (exprConst) {
+        if (exprIntVal < 0 || (len > 0 && exprIntVal >= len)) fatalError("Index out of range");
+        if (boundsMode != 2) return;
+    }
+    if (!boundsMode) return;
+    if (boundsMode == 1) {
+        while (k >= 0 && loopVar[k] != plainVar) k--;
+        if (plainVar >= 0 && k >= 0 && loopMods[k] == 0
+            && (len > 0 ? loopOpen[k] < 0 && loopBound[k] <= len : loopOpen[k] == -len - 1) && loopLowSafe[k]) {
+            state = 2;
+        } else if (exprLocal && hoistAllowed && condRegion == 0) {
+            found = findChecked(start, len);
+            if (found >= 0) {
+                hoistCheck(found);
+                return;
+            }
+            if (checkedCount < MAXCHECKED) {
+                checkedStart[checkedCount] = bufferLen[BUFCHECK];
+                bufferAppendRange(BUFCHECK, bufferData[emitBuffer] + start, bufferLen[emitBuffer] - start);
+                checkedEnd[checkedCount] = bufferLen[BUFCHECK];
+                checkedLen[checkedCount] = len;
+                checkedGuard[checkedCount++] = guardCount;
+            }
+        }
+    }
+    if (guardCount >= guardCapacity) {
+        guardCapacity = guardCapacity ? guardCapacity * 2 : STABSIZE;
+        guardLen = (int *)growArray(guardLen, guardCapacity, sizeof(int));
+        guardLine = (int *)growArray(guardLine, guardCapacity, sizeof(int));
+        guardState = (int *)growArray(guardState, guardCapacity, sizeof(int));
+        guardLoop = (int *)growArray(guardLoop, guardCapacity, sizeof(int));
+    }
+    guardLen[guardCount] = len;
+    guardLine[guardCount] = currentLine;
+    guardState[guardCount] = state;
+    guardLoop[guardCount] = state == 2 ? k : top;
+    sprintf(marker, "\001%d;", guardCount);
+    emitInsert(start, marker);
+    sprintf(marker, "\002%d;", guardCount);
+    emitCode(marker);
+    guardCount++;
+}
+
+int parseDesignator(void) {
+    int tid = 0, len, local, rec, field, root, open, readOnly, k, var, deref = 0, counter = 0;
+    long start;
+    int idxType, modIndex;
+    char name[MAXIDLEN + 24];
+    strcpy(desMName, moduleName);
+    if(symbolTableFoundType == TSYMAMOD) {
         symbolTableFoundIndex = symbolTableId[symbolTableFoundIndex];
         symbolTableFoundName = &symbolTableNameBuffer[symbolTable[symbolTableFoundIndex]];
         symbolTableFoundType = symbolTableType[symbolTableFoundIndex];
     }
     if((symbolTableFoundType == TSYMTHISMOD) || (symbolTableFoundType == TSYMIMOD)) {
+        modIndex = symbolTableFoundIndex;
         strcpy(desMName, symbolTableFoundName);
         matchSymbol(TIDENT, "module name expected");
         matchSymbol(TDOT, ". expected");
-        if (currentSymbol == TIDENT) {
-            symbolTableFind(currentToken);
+        if (currentSymbol == TIDENT && symbolTableType[modIndex] == TSYMIMOD) {
+            sprintf(desQualName, "%s.%s", desMName, currentToken);
+            if (!symbolTableFind(desQualName) && symbolTableDataType[modIndex] == 1) {
+                fatalError("Undeclared identifier");
+            }
         }
     }
+    if (symbolTableType[symbolTableFoundIndex] == TSYMTYPE) fatalError("Type name not allowed here");
     tid = symbolTableDataType[symbolTableFoundIndex];
+    exprConst = symbolTableType[symbolTableFoundIndex] == TSYMCONST && tid != 7;
+    exprIntVal = symbolTableIntValue[symbolTableFoundIndex];
+    exprRealVal = symbolTableRealValue[symbolTableFoundIndex];
+    root = symbolTableFoundIndex;
+    local = exprConst || (symbolTableLevel[root] > 0 && symbolTableType[root] != TSYMPROC && symbolTableType[root] != TSYMVARPARAM);
+    plainVar = isPlainInteger(root) ? root : -1;
+    open = typeForm[tid] == 7 && typeLen[tid] == 0 ? root : -1;
+    readOnly = typeForm[tid] == 7 && symbolTableType[root] == TSYMPARAM;
+    for (k = 0; k < loopCount; k++) {
+        if (loopFor[k] == root) {
+            readOnly = 2;
+            counter = loopCounter[k];
+        }
+    }
+    var = root;
     consumeIdentifier(desName);
-    emitCode(desMName);
-    emitCode("_");
-    emitCode(desName);
-    while (checkLexeme(TLBRACK)) {
-        if (typeForm[tid] != 7) fatalError("Array expected");
-        tid = typeBase[tid];
-        emitCode("[");
-        idxType = parseExpression();
-        checkTypeCompatibility(idxType, 1);
+    if (symbolTableType[root] == TSYMVARPARAM && typeForm[tid] != 7) emitCode("(*");
+    if (counter > 0) {
+        sprintf(name, "%s_for_%d_i", moduleName, counter);
+        emitCode(name);
+    } else {
+        emitCode(desMName);
+        emitCode("_");
+        emitCode(desName);
+    }
+    if (symbolTableType[root] == TSYMVARPARAM && typeForm[tid] != 7) emitCode(")");
+    while (currentSymbol == TLBRACK || currentSymbol == TDOT) {
+        var = -1;
+        if (checkLexeme(TDOT)) {
+            rec = typeForm[tid] == 8 ? typeBase[tid] : tid;
+            if (typeForm[rec] != 12) fatalError("Record expected");
+            if (currentSymbol != TIDENT) fatalError("Field name expected");
+            field = fieldFind(rec, currentToken);
+            if (field == 0) fatalError("Unknown field");
+            if (typeForm[field] == 13 && typeBase[rec] == 1) fatalError("Field not exported");
+            if (rec != tid) deref = 1;
+            emitCode(rec == tid ? "." : "->");
+            emitCode(currentToken);
+            nextToken();
+            tid = typeBase[field];
+            exprConst = 0;
+            plainVar = -1;
+            open = -1;
+            continue;
+        }
+        nextToken();
+        do {
+            if (typeForm[tid] != 7 && typeForm[tid] != 8) fatalError("Array expected");
+            if (typeForm[tid] == 8) deref = 1;
+            len = typeForm[tid] == 7 ? typeLen[tid] : 0;
+            if (open >= 0) len = -(open + 1);
+            open = -1;
+            tid = typeBase[tid];
+            emitCode("[");
+            start = bufferLen[emitBuffer];
+            idxType = parseExpression();
+            checkTypeCompatibility(idxType, 1);
+            if (len != 0) emitIndexGuard(start, len);
+            local = local && exprLocal;
+            emitCode("]");
+            exprConst = 0;
+            plainVar = -1;
+        } while (checkLexeme(TCOMMA));
         matchSymbol(TRBRACK, "] expected");
-        emitCode("]");
     }
+    exprLocal = local;
+    desOpen = open;
+    desReadOnly = readOnly;
+    desVar = var;
+    desRoot = root;
+    desDeref = deref;
     return tid;
 }
 
-void parseParameters(void) {
+void checkWritable(void) {
+    if (desReadOnly == 2) fatalError("FOR variable cannot be changed");
+    if (desReadOnly) fatalError("Read-only parameter");
+}
+
+void noteCall(int proc) {
+    callCount++;
+    forgetGlobals();
+    if (proc < 0 || symbolTableType[proc] != TSYMPROC || symbolTableIntValue[proc] <= 0) return;
+    procLeaf = 0;
+    if (loopCount > 0 || loopHeader > 0 || proc == curProcIndex) profHot[symbolTableIntValue[proc] - 1] = 1;
+}
+
+void checkParameterCount(int sig, int n) {
+    if (typeForm[sig] != 10) return;
+    if (n > typeLen[sig]) fatalError("Too many parameters");
+    if (n < typeLen[sig]) fatalError("Too few parameters");
+}
+
+int isOpenArray(int t) {
+    return typeForm[t] == 7 && typeLen[t] == 0;
+}
+
+int sameType(int t1, int t2) {
+    if (t1 == t2 || t1 == 0 || t2 == 0) return 1;
+    if (typeForm[t1] == 7 && typeForm[t2] == 7) return typeLen[t1] == typeLen[t2] && sameType(typeBase[t1], typeBase[t2]);
+    if (typeForm[t1] == 8 && typeForm[t2] == 8) return typeBase[t1] == 0 || typeBase[t2] == 0 || sameType(typeBase[t1], typeBase[t2]);
+    return 0;
+}
+
+void checkSameType(int t1, int t2) {
+    if (sameType(t1, t2)) return;
+    diagnostic("%s:%d: Type mismatch: %d != %d\n", sourceFileName, currentLine, t1, t2);
+    stopTranslation();
+}
+
+void parseReference(int pt, int isVar) {
+    int t;
+    char buf[MAXIDLEN * 2 + 16];
+    if (isOpenArray(pt) && !isVar && currentSymbol == TSTRING) {
+        checkTypeCompatibility(typeBase[pt], 6);
+        emitCode(currentToken);
+        sprintf(buf, ", %d", (int)strlen(currentToken) - 1);
+        emitCode(buf);
+        nextToken();
+        return;
+    }
+    if (currentSymbol != TIDENT) fatalError("Variable expected");
+    if (typeForm[pt] != 7) emitCode("&");
+    t = parseDesignator();
+    if (isVar) checkWritable();
+    if (isOpenArray(pt)) {
+        if (typeForm[t] != 7) fatalError("Array expected");
+        checkSameType(typeBase[pt], typeBase[t]);
+        if (desOpen >= 0) sprintf(buf, ", %s_%s_len", moduleName, &symbolTableNameBuffer[symbolTable[desOpen]]);
+        else sprintf(buf, ", %d", typeLen[t]);
+        emitCode(buf);
+    } else {
+        checkSameType(pt, t);
+    }
+    if (isVar && plainVar >= 0) noteAssignment(plainVar, 0);
+}
+
+void parseParameters(int sig) {
+    int n = 0, t, p;
     matchSymbol(TLPAREN, "( expected");
     emitCode("(");
     if (currentSymbol != TRPAREN) {
         do {
-            parseExpression();
+            p = typeForm[sig] == 10 && n < typeLen[sig] ? sig + 1 + n : 0;
+            if (p > 0 && (typeLen[p] || isOpenArray(typeBase[p]))) {
+                parseReference(typeBase[p], typeLen[p]);
+            } else {
+                t = parseExpression();
+                if (p > 0) checkTypeCompatibility(typeBase[p], t);
+            }
+            n++;
             if (checkLexeme(TCOMMA)) emitCode(", ");
             else break;
         } while (1);
     }
+    checkParameterCount(sig, n);
     matchSymbol(TRPAREN, ") expected");
     emitCode(")");
 }
@@ -520,22 +1771,199 @@ int parseUnaryFunc(char *pre, char *suf, int inT, int outT) {
     return outT;
 }
 
+const char *basicCName(int t) {
+    static const char *names[] = {"", "int", "long", "float", "double", "bool", "char"};
+    return names[t];
+}
+
+int parseVecArray(int numeric, char *count) {
+    int t, n = 1, open;
+    if (currentSymbol != TIDENT) fatalError("Array expected");
+    t = parseDesignator();
+    if (typeForm[t] != 7) fatalError("Array expected");
+    open = desOpen;
+    while (typeForm[t] == 7) {
+        if (typeLen[t] > 0) n *= typeLen[t];
+        t = typeBase[t];
+    }
+    if (t < 1 || t > (numeric ? 4 : 6)) fatalError(numeric ? "Numeric array expected" : "Array of basic type expected");
+    if (open < 0) sprintf(count, "%d", n);
+    else if (n > 1) sprintf(count, "%s_%s_len * %d", moduleName, &symbolTableNameBuffer[symbolTable[open]], n);
+    else sprintf(count, "%s_%s_len", moduleName, &symbolTableNameBuffer[symbolTable[open]]);
+    return t;
+}
+
+void emitHelpers(void) {
+    char buf[MAXIDLEN + 256];
+    const char *c;
+    long n = 1, i;
+    bufferReset(BUFARGS);
+    if (divHelpers & 1) {
+        sprintf(buf, "static inline long %s_DIV(long a, long b) {\n    return a / b - ((a %% b != 0) & ((a ^ b) < 0));\n}\n", moduleName);
+        bufferAppend(BUFARGS, buf);
+    }
+    if (divHelpers & 2) {
+        sprintf(buf, "static inline long %s_MOD(long a, long b) {\n    long r = a %% b;\n    return r + (b & -(long)((r != 0) & ((r ^ b) < 0)));\n}\n", moduleName);
+        bufferAppend(BUFARGS, buf);
+    }
+    for (i = 0; i < 16; i++) {
+        if (!(vecHelpers & (1 << i))) continue;
+        c = basicCName((int)(i % 8));
+        if (i >= 8) {
+            sprintf(buf, "static inline %s %s_VDOT_%s(const %s *restrict a, const %s *restrict b, long n) {\n"
+                "    %s s = 0;\n    long i;\n    for (i = 0; i < n; i++) s += a[i] * b[i];\n    return s;\n}\n", c, moduleName, c, c, c, c);
+        } else {
+            sprintf(buf, "static inline %s %s_VSUM_%s(const %s *restrict a, long n) {\n"
+                "    %s s = 0;\n    long i;\n    for (i = 0; i < n; i++) s += a[i];\n    return s;\n}\n", c, moduleName, c, c, c);
+        }
+        bufferAppend(BUFARGS, buf);
+    }
+    if (bufferLen[BUFARGS] == 0) return;
+    if (linesMode) {
+        for (i = 0; i < helperPos; i++) n += bufferData[BUFC][i] == '\n';
+        sprintf(buf, "#line %ld ", n);
+        bufferAppend(BUFARGS, buf);
+        lineFileName(BUFARGS, outputNameC);
+        bufferAppend(BUFARGS, "\n");
+    }
+    emitBuffer = BUFC;
+    emitInsert(helperPos, bufferData[BUFARGS]);
+}
+
+int parseVecReduce(int dot) {
+    int t;
+    long start = bufferLen[emitBuffer];
+    char count[MAXIDLEN * 2 + 24], other[MAXIDLEN * 2 + 24], buf[MAXIDLEN * 2 + 48];
+    nextToken();
+    matchSymbol(TLPAREN, "( expected");
+    t = parseVecArray(1, count);
+    sprintf(buf, "%s_%s_%s((const %s *)(", moduleName, dot ? "VDOT" : "VSUM", basicCName(t), basicCName(t));
+    emitInsert(start, buf);
+    emitCode(")");
+    if (dot) {
+        matchSymbol(TCOMMA, ", expected");
+        sprintf(buf, ", (const %s *)(", basicCName(t));
+        emitCode(buf);
+        if (parseVecArray(1, other) != t || strcmp(count, other) != 0) fatalError("Arrays of equal length expected");
+        emitCode(")");
+    }
+    matchSymbol(TRPAREN, ") expected");
+    sprintf(buf, ", %s)", count);
+    emitCode(buf);
+    vecHelpers |= 1 << (dot * 8 + t);
+    exprConst = 0;
+    exprLocal = 0;
+    return t;
+}
+
+long floorDivMod(long a, long b, int wantMod) {
+    ldiv_t d;
+    if (b == 0) fatalError("Division by zero");
+    d = ldiv(a, b);
+    if (d.rem != 0 && (d.rem < 0) != (b < 0)) {
+        d.quot--;
+        d.rem += b;
+    }
+    return wantMod ? d.rem : d.quot;
+}
+
+int powerOfTwo(long v) {
+    int k = 0;
+    if (v <= 0) return -1;
+    while (!(v & 1)) {
+        v >>= 1;
+        k++;
+    }
+    return v == 1 ? k : -1;
+}
+
+void emitDivMod(int op, long left, long right) {
+    char buf[64];
+    int k;
+    if (exprConst && exprIntVal == 0) fatalError("Division by zero");
+    k = exprConst ? powerOfTwo(exprIntVal) : -1;
+    if (k >= 0) {
+        emitTruncate(right);
+        if (op == TDIV) sprintf(buf, " >> %d)", k);
+        else sprintf(buf, " & %ld)", exprIntVal - 1);
+        emitCode(buf);
+        emitInsert(left, "(");
+    } else {
+        emitInsert(right, ", ");
+        emitCode(")");
+        sprintf(buf, "%s_%s(", moduleName, op == TDIV ? "DIV" : "MOD");
+        emitInsert(left, buf);
+        divHelpers |= op == TDIV ? 1 : 2;
+    }
+}
+
+int foldBinary(int op, int t, long a, double x) {
+    long b = exprIntVal;
+    double y = exprRealVal;
+    int cmp, isReal = (t == 3 || t == 4);
+    if (op >= TEQ && op <= TGTE) {
+        if (isReal) cmp = (x > y) - (x < y);
+        else cmp = (a > b) - (a < b);
+        if (op == TEQ) exprIntVal = cmp == 0;
+        else if (op == TNEQ) exprIntVal = cmp != 0;
+        else if (op == TLT) exprIntVal = cmp < 0;
+        else if (op == TLTE) exprIntVal = cmp <= 0;
+        else if (op == TGT) exprIntVal = cmp > 0;
+        else exprIntVal = cmp >= 0;
+        return 1;
+    }
+    if (isReal) {
+        if (op == TPLUS) exprRealVal = x + y;
+        else if (op == TMINUS) exprRealVal = x - y;
+        else if (op == TMUL) exprRealVal = x * y;
+        else return 0;
+        return 1;
+    }
+    if (op == TPLUS) exprIntVal = a + b;
+    else if (op == TMINUS) exprIntVal = a - b;
+    else if (op == TMUL) exprIntVal = a * b;
+    else if (op == TDIV) exprIntVal = floorDivMod(a, b, 0);
+    else if (op == TMOD) exprIntVal = floorDivMod(a, b, 1);
+    else if (op == TOR) exprIntVal = a || b;
+    else if (op == TAND) exprIntVal = a && b;
+    else return 0;
+    return 1;
+}
+
 int parseFactor(void) {
     int tid = 0;
-    int argT, t1, t2;
+    int argT, t1, t2, c1, l1;
+    long start, comma, i1;
+    char buf[MAXIDLEN * 2 + 8];
+    int symbol = currentSymbol;
+    exprConst = 0;
+    exprLocal = 1;
+    lenOpen = -1;
     if (currentSymbol == TNUMBER) {
         emitCode(currentToken);
-        if (strchr(currentToken, '.') || strchr(currentToken, 'E')) tid = 3;
-        else tid = 1;
+        tid = numberType(currentToken);
+        setConstantValue(currentToken, tid);
         nextToken();
     } else if (currentSymbol == TCHAR) {
         emitCode(currentToken);
         tid = 6;
+        setConstantValue(currentToken, tid);
         nextToken();
     } else if (currentSymbol == TSTRING) {
         emitCode(currentToken);
         tid = 7;
         nextToken();
+    } else if (checkLexeme(TTRUE)) {
+        emitCode("true");
+        tid = 5;
+        setConstantValue("true", tid);
+    } else if (checkLexeme(TFALSE)) {
+        emitCode("false");
+        tid = 5;
+        setConstantValue("false", tid);
+    } else if (checkLexeme(TNIL)) {
+        emitCode("NULL");
+        tid = 8;
     } else if (checkLexeme(TLPAREN)) {
         emitCode("(");
         tid = parseExpression();
@@ -545,94 +1973,250 @@ int parseFactor(void) {
         emitCode("!");
         tid = parseFactor();
         checkTypeCompatibility(tid, 5);
+        exprIntVal = !exprIntVal;
     } else if (currentSymbol == TFABS) {
         nextToken();
         matchSymbol(TLPAREN, "( expected");
+        start = bufferLen[emitBuffer];
         argT = parseExpression();
-        if (argT == 3 || argT == 4) emitCode("fabs(");
-        else emitCode("abs(");
+        if (argT == 3 || argT == 4) emitInsert(start, "fabs(");
+        else emitInsert(start, "abs(");
         matchSymbol(TRPAREN, ") expected");
         emitCode(")");
         tid = argT;
+        if (exprIntVal < 0) exprIntVal = -exprIntVal;
+        exprRealVal = fabs(exprRealVal);
     } else if (currentSymbol == TFODD) {
         tid = parseUnaryFunc("((", ") & 1)", 1, 5);
+        exprIntVal = exprIntVal & 1;
     } else if (currentSymbol == TFASH) {
         nextToken();
         matchSymbol(TLPAREN, "( expected");
-        fprintf(fileC, "%s_ASH(", moduleName);
+        start = bufferLen[emitBuffer];
         t1 = parseExpression();
         checkTypeCompatibility(t1, 1);
+        c1 = exprConst;
+        i1 = exprIntVal;
+        l1 = exprLocal;
         matchSymbol(TCOMMA, ", expected");
+        comma = bufferLen[emitBuffer];
         emitCode(", ");
         t2 = parseExpression();
         checkTypeCompatibility(t2, 1);
         matchSymbol(TRPAREN, ") expected");
-        emitCode(")");
+        if (exprConst && exprIntVal > -32 && exprIntVal < 32) {
+            emitTruncate(comma);
+            if (exprIntVal >= 0) sprintf(buf, " << %ld)", exprIntVal);
+            else sprintf(buf, " >> %ld)", -exprIntVal);
+            emitCode(buf);
+            emitInsert(start, "(");
+        } else {
+            emitCode(")");
+            sprintf(buf, "%s_ASH(", moduleName);
+            emitInsert(start, buf);
+        }
         tid = t1;
-    } else if (currentSymbol == TFASSERT) {
-        tid = parseUnaryFunc("if (!(", ")) abort()", 5, 0);
+        exprLocal = l1 && exprLocal;
+        exprConst = c1 && exprConst && exprIntVal > -32 && exprIntVal < 32;
+        if (exprConst && exprIntVal >= 0) exprIntVal = i1 * (1L << exprIntVal);
+        else if (exprConst) exprIntVal = floorDivMod(i1, 1L << -exprIntVal, 0);
     } else if (currentSymbol == TFORD) {
         tid = parseUnaryFunc("((int)(", "))", 0, 1);
     } else if (currentSymbol == TFCHR) {
         tid = parseUnaryFunc("((char)(", "))", 1, 6);
+        exprIntVal = exprIntVal & 0xFF;
     } else if (currentSymbol == TFFLOOR) {
         tid = parseUnaryFunc("((long)floor(", "))", 3, 2);
+        exprIntVal = (long)floor(exprRealVal);
+    } else if (checkLexeme(TFLEN)) {
+        matchSymbol(TLPAREN, "( expected");
+        if (currentSymbol != TIDENT) fatalError("Array expected");
+        start = bufferLen[emitBuffer];
+        argT = parseDesignator();
+        bufferDelete(emitBuffer, start, bufferLen[emitBuffer] - start);
+        if (typeForm[argT] != 7) fatalError("Array expected");
+        if (desOpen >= 0) {
+            sprintf(buf, "%s_%s_len", moduleName, &symbolTableNameBuffer[symbolTable[desOpen]]);
+            exprConst = 0;
+        } else {
+            sprintf(buf, "%d", typeLen[argT]);
+            setConstantValue(buf, 1);
+        }
+        emitCode(buf);
+        matchSymbol(TRPAREN, ") expected");
+        lenOpen = desOpen;
+        tid = 1;
+    } else if (currentSymbol == TFVSUM || currentSymbol == TFVDOT) {
+        tid = parseVecReduce(currentSymbol == TFVDOT);
     } else if (currentSymbol == TIDENT) {
         tid = parseDesignator();
         if (currentSymbol == TLPAREN) {
-            parseParameters();
+            noteCall(desVar);
+            parseParameters(tid);
+            if (typeForm[tid] == 10) tid = typeBase[tid];
+            exprConst = 0;
+            exprLocal = 0;
+            plainVar = -1;
         }
     } else {
         fatalError("Factor expected");
     }
+    if (symbol != TIDENT && symbol != TLPAREN) plainVar = -1;
+    if (symbol != TLPAREN) relVar = -1;
     return tid;
 }
 
 int parseTerm(void) {
-    int t2, t1;
+    int t2, t1, op, c1, local, rel, var, divide, open, len;
+    long start = bufferLen[emitBuffer], i1, bound, right;
+    double r1;
     emitCode("(");
     t1 = parseFactor();
+    local = exprLocal;
+    rel = relVar;
+    bound = relBound;
+    open = relOpen;
+    var = plainVar;
+    len = lenOpen;
     while (currentSymbol >= TMUL && currentSymbol <= TAND) {
-        emitCode(getOperatorString(currentSymbol));
+        op = currentSymbol;
+        c1 = exprConst;
+        i1 = exprIntVal;
+        r1 = exprRealVal;
+        divide = op == TDIV || op == TMOD;
+        if (!divide) emitCode(getOperatorString(op));
+        right = bufferLen[emitBuffer];
         nextToken();
+        if (op == TAND) condRegion++;
         t2 = parseFactor();
+        if (op == TAND) condRegion--;
         checkTypeCompatibility(t1, t2);
+        if (divide && (t1 == 3 || t1 == 4 || t2 == 3 || t2 == 4)) emitInsert(right, getOperatorString(op));
+        else if (divide) emitDivMod(op, start + 1, right);
+        exprConst = c1 && exprConst && foldBinary(op, t1, i1, r1);
+        local = local && exprLocal;
+        if (op != TAND) rel = -2;
+        else if (rel == -1) {
+            rel = relVar;
+            bound = relBound;
+            open = relOpen;
+        }
+        var = -1;
+        len = -1;
     }
     emitCode(")");
+    emitFolded(start, t1);
+    exprLocal = local;
+    relVar = rel < 0 ? -1 : rel;
+    relBound = bound;
+    relOpen = open;
+    plainVar = var;
+    lenOpen = len;
     return t1;
 }
 
 int parseSimpleExpression(void) {
-    int t1, t2;
+    int t1, t2, op, c1, local, rel, var, open, len, pred = -1, negate = 0;
+    long start = bufferLen[emitBuffer], i1, bound;
+    double r1;
     if (checkLexeme(TPLUS)) { }
-    else if (checkLexeme(TMINUS)) emitCode("-");
+    else if (checkLexeme(TMINUS)) {
+        emitCode("-");
+        negate = 1;
+    }
     t1 = parseTerm();
+    local = exprLocal;
+    rel = relVar;
+    bound = relBound;
+    open = relOpen;
+    var = plainVar;
+    len = lenOpen;
+    if (negate) {
+        exprIntVal = -exprIntVal;
+        exprRealVal = -exprRealVal;
+        rel = -1;
+        var = -1;
+        len = -1;
+    }
     while (currentSymbol >= TPLUS && currentSymbol <= TOR) {
-        emitCode(getOperatorString(currentSymbol));
+        op = currentSymbol;
+        c1 = exprConst;
+        i1 = exprIntVal;
+        r1 = exprRealVal;
+        emitCode(getOperatorString(op));
         nextToken();
+        if (op == TOR) condRegion++;
         t2 = parseTerm();
+        if (op == TOR) condRegion--;
         checkTypeCompatibility(t1, t2);
+        pred = op == TMINUS && len >= 0 && exprConst && exprIntVal == 1 ? len : -1;
+        exprConst = c1 && exprConst && foldBinary(op, t1, i1, r1);
+        local = local && exprLocal;
+        rel = -1;
+        var = -1;
+        len = -1;
     }
+    emitFolded(start, t1);
+    exprLocal = local;
+    relVar = rel;
+    relBound = bound;
+    relOpen = open;
+    plainVar = var;
+    lenOpen = len;
+    lenPredOpen = pred;
     return t1;
 }
 
 int parseExpression(void) {
-    int t1, t2;
+    int t1, t2, op, c1, local, var;
+    long start = bufferLen[emitBuffer], i1;
+    double r1;
     emitCode("(");
     t1 = parseSimpleExpression();
     emitCode(")");
     if (currentSymbol >= TEQ && currentSymbol <= TGTE) {
-        emitCode(getOperatorString(currentSymbol));
+        op = currentSymbol;
+        c1 = exprConst;
+        i1 = exprIntVal;
+        r1 = exprRealVal;
+        local = exprLocal;
+        var = plainVar;
+        emitCode(getOperatorString(op));
         nextToken();
         emitCode("(");
         t2 = parseSimpleExpression();
         checkTypeCompatibility(t1, t2);
+        if (typeForm[t1] == 12) fatalError("Records cannot be compared");
         emitCode(")");
+        relVar = -1;
+        if ((op == TLT || op == TLTE) && var >= 0 && exprConst) {
+            relVar = var;
+            relBound = op == TLT ? exprIntVal : exprIntVal + 1;
+            relOpen = -1;
+        } else if (op == TLT && var >= 0 && lenOpen >= 0) {
+            relVar = var;
+            relOpen = lenOpen;
+        }
+        exprLocal = local && exprLocal;
+        plainVar = -1;
+        exprConst = c1 && exprConst && foldBinary(op, t1, i1, r1);
+        emitFolded(start, 5);
         return 5;
     }
+    emitFolded(start, t1);
     return t1;
 }
 
+int parseConstExpression(void) {
+    int tid, saved = emitBuffer;
+    emitBuffer = BUFCONST;
+    bufferReset(BUFCONST);
+    tid = parseExpression();
+    emitBuffer = saved;
+    if (!exprConst) fatalError("Constant expression expected");
+    return tid;
+}
+
 int parseBasicType(char *prefix, char *suffix) {
     int targetId;
     int tid = 0;
@@ -642,16 +2226,23 @@ int parseBasicType(char *prefix, char *suffix) {
     if (currentSymbol == TIDENT) {
         if (symbolTableFind(currentToken)) {
             if (symbolTableFoundType == TSYMIMOD || symbolTableFoundType == TSYMAMOD) {
-                if (symbolTableFoundType == TSYMAMOD) {
-                    targetId = symbolTableId[symbolTableFoundIndex];
-                    strcpy(basicTypeModName, &symbolTableNameBuffer[symbolTable[targetId]]);
-                } else {
-                    strcpy(basicTypeModName, symbolTableFoundName);
-                }
+                targetId = symbolTableFoundIndex;
+                if (symbolTableFoundType == TSYMAMOD) targetId = symbolTableId[symbolTableFoundIndex];
+                strcpy(basicTypeModName, &symbolTableNameBuffer[symbolTable[targetId]]);
                 nextToken();
                 matchSymbol(TDOT, ". expected");
                 if (currentSymbol != TIDENT) fatalError("Type identifier expected after module");
                 sprintf(basicTypeName, "%s_%s", basicTypeModName, currentToken);
+                sprintf(desQualName, "%s.%s", basicTypeModName, currentToken);
+                if (symbolTableFind(desQualName) && symbolTableFoundType == TSYMTYPE) {
+                    tid = symbolTableDataType[symbolTableFoundIndex];
+                } else if (symbolTableDataType[targetId] == 1) {
+                    fatalError("Undeclared type");
+                }
+                isQualified = 1;
+            } else if (symbolTableFoundType == TSYMTYPE) {
+                sprintf(basicTypeName, "%s_%s", moduleName, currentToken);
+                tid = symbolTableDataType[symbolTableFoundIndex];
                 isQualified = 1;
             } else {
                 tid = symbolTableDataType[symbolTableFoundIndex];
@@ -687,68 +2278,186 @@ int parseBasicType(char *prefix, char *suffix) {
 }
 
 int parseArraySize(char *buf) {
-    int len = 0;
-    if (currentSymbol == TNUMBER) {
-        strcpy(buf, currentToken);
-        len = atoi(currentToken);
-        nextToken();
-    } else if (currentSymbol == TIDENT) {
-        if (symbolTableFind(currentToken)) {
-            strcpy(buf, moduleName);
-            if(symbolTableFoundType == TSYMAMOD) {
-                symbolTableFoundIndex = symbolTableId[symbolTableFoundIndex];
-                symbolTableFoundName = &symbolTableNameBuffer[symbolTable[symbolTableFoundIndex]];
-                symbolTableFoundType = symbolTableType[symbolTableFoundIndex];
-            }
-            if((symbolTableFoundType == TSYMTHISMOD) || (symbolTableFoundType == TSYMIMOD)) {
-                strcpy(buf, symbolTableFoundName);
-                matchSymbol(TIDENT, "module name expected");
-                matchSymbol(TDOT, ". expected");
-            }
-            if (symbolTableFoundType == TSYMCONST) {
-                strcat(buf, "_");
-                strcat(buf, currentToken);
-            } else {
-                strcpy(buf, currentToken);
+    int tid = parseConstExpression();
+    if (tid != 1 && tid != 2) fatalError("Integer constant expected");
+    if (exprIntVal <= 0) fatalError("Array size must be positive");
+    sprintf(buf, "%ld", exprIntVal);
+    return (int)exprIntVal;
+}
+
+void fieldPush(int name) {
+    if (fieldCount >= fieldCapacity) {
+        fieldCapacity = fieldCapacity ? fieldCapacity * 2 : 64;
+        fieldType = (int *)growArray(fieldType, fieldCapacity, sizeof(int));
+        fieldName = (int *)growArray(fieldName, fieldCapacity, sizeof(int));
+        fieldDecl = (int *)growArray(fieldDecl, fieldCapacity, sizeof(int));
+        fieldMark = (int *)growArray(fieldMark, fieldCapacity, sizeof(int));
+        fieldOrder = (int *)growArray(fieldOrder, fieldCapacity, sizeof(int));
+    }
+    fieldType[fieldCount] = 0;
+    fieldName[fieldCount] = name;
+    fieldMark[fieldCount] = 0;
+    fieldCount++;
+}
+
+int fieldBefore(int a, int b, int coldUp) {
+    if ((fieldMark[a] & 2) != (fieldMark[b] & 2)) return fieldMark[a] & 2;
+    if (coldUp && !(fieldMark[a] & 2)) return typeAlign(fieldType[a]) < typeAlign(fieldType[b]);
+    return typeAlign(fieldType[a]) > typeAlign(fieldType[b]);
+}
+
+void layoutSort(int start, int n, int coldUp) {
+    int i, j, k, v;
+    for (i = start; i < start + n; i++) {
+        if (fieldMark[i] & 1) continue;
+        v = i;
+        j = i;
+        for (k = j - 1; k >= start; k--) {
+            if (fieldMark[k] & 1) continue;
+            if (!fieldBefore(v, fieldOrder[k], coldUp)) break;
+            fieldOrder[j] = fieldOrder[k];
+            j = k;
+        }
+        fieldOrder[j] = v;
+    }
+}
+
+long layoutSize(int start, int n, int ordered) {
+    long size = 0, a, m = 1;
+    int i, f;
+    layoutHotEnd = 0;
+    for (i = start; i < start + n; i++) {
+        f = ordered ? fieldOrder[i] : i;
+        a = typeAlign(fieldType[f]);
+        if (a > m) m = a;
+        size = (size + a - 1) / a * a + typeSize(fieldType[f]);
+        if (fieldMark[f] & 2) layoutHotEnd = size;
+    }
+    return (size + m - 1) / m * m;
+}
+
+void layoutRecord(int start, int n) {
+    int i, hot = 0;
+    long size;
+    for (i = start; i < start + n; i++) fieldOrder[i] = i;
+    if (!layoutMode) return;
+    for (i = start; i < start + n; i++) {
+        if (typeSize(fieldType[i]) == 0) return;
+        if (fieldMark[i] & 2) hot = 1;
+    }
+    layoutSort(start, n, 0);
+    if (!hot) return;
+    size = layoutSize(start, n, 1);
+    layoutSort(start, n, 1);
+    if (layoutSize(start, n, 1) >= size) layoutSort(start, n, 0);
+}
+
+int parseRecord(const char *cname, int self) {
+    int start = fieldCount, first, i, t, n, rec;
+    long size, declared;
+    char prefix[MAXTYPELEN], suffix[MAXTYPELEN], decl[MAXTYPELEN * 2 + MAXIDLEN];
+    while (currentSymbol == TIDENT) {
+        first = fieldCount;
+        do {
+            if (currentSymbol != TIDENT) fatalError("Field name expected");
+            for (i = start; i < fieldCount; i++) {
+                if (strcmp(&fieldNames[fieldName[i]], currentToken) == 0) fatalError("Duplicate field");
             }
+            fieldPush(fieldNameAdd(currentToken, (int)strlen(currentToken)));
             nextToken();
-        } else fatalError("Array size expected");
-    } else fatalError("Array size expected");
-    return len;
+            if (checkLexeme(TMUL)) fieldMark[fieldCount - 1] |= 1;
+            if (checkLexeme(TPLUS)) fieldMark[fieldCount - 1] |= 2;
+        } while (checkLexeme(TCOMMA));
+        matchSymbol(TCOLON, ": expected");
+        t = parseType(prefix, suffix);
+        for (i = t; typeForm[i] == 7; i = typeBase[i]);
+        if (i == self) fatalError("Record contains itself");
+        for (i = first; i < fieldCount; i++) {
+            fieldType[i] = t;
+            sprintf(decl, "%s %s%s", prefix, &fieldNames[fieldName[i]], suffix);
+            fieldDecl[i] = fieldNameAdd(decl, (int)strlen(decl));
+        }
+        if (!checkLexeme(TSEMICOL)) break;
+    }
+    matchSymbol(TEND, "END expected");
+    n = fieldCount - start;
+    if (n == 0) fatalError("Empty record");
+    layoutRecord(start, n);
+    rec = typeTableAdd(12, 0, n);
+    bufferAppend(BUFH, "struct ");
+    bufferAppend(BUFH, cname);
+    bufferAppend(BUFH, " {\n");
+    for (i = start; i < start + n; i++) {
+        t = fieldOrder[i];
+        typeTableAdd(fieldMark[t] & 1 ? 14 : 13, fieldType[t], fieldName[t]);
+        bufferAppend(BUFH, "    ");
+        bufferAppend(BUFH, &fieldNames[fieldDecl[t]]);
+        bufferAppend(BUFH, ";\n");
+    }
+    bufferAppend(BUFH, "};\n");
+    size = typeSize(rec);
+    if (layoutMode && size > 0) {
+        declared = layoutSize(start, n, 0);
+        layoutSize(start, n, 1);
+        diagnostic("layout file=%s record=%s fields=%d size=%ld declared=%ld hot=%ld\n", sourceFileName, cname, n, size, declared, layoutHotEnd);
+        if (layoutHotEnd > CACHELINE) diagnostic("%s:%d: Warning: hot fields of %s end at byte %ld\n", sourceFileName, currentLine, cname, layoutHotEnd);
+    }
+    fieldCount = start;
+    return rec;
+}
+
+int parseArrayType(char *prefix, char *suffix) {
+    char size[MAXIDLEN];
+    int base, arrLen = parseArraySize(size);
+    if (checkLexeme(TCOMMA)) {
+        base = parseArrayType(prefix, suffix);
+    } else {
+        matchSymbol(TOF, "OF expected");
+        base = parseType(prefix, suffix);
+    }
+    if (strlen(size) + strlen(suffix) + 3 > MAXTYPELEN) fatalError("Too many array dimensions");
+    memmove(suffix + strlen(size) + 2, suffix, strlen(suffix) + 1);
+    suffix[0] = '[';
+    memcpy(suffix + 1, size, strlen(size));
+    suffix[strlen(size) + 1] = ']';
+    return typeTableAdd(7, base, arrLen);
 }
 
 int parseType(char *prefix, char *suffix) {
-    int tid = 0, base;
+    int tid = 0, base, open = openArrayAllowed;
+    openArrayAllowed = 0;
     prefix[0] = 0;
     suffix[0] = 0;
     if (checkLexeme(TPOINTER)) {
         if (checkLexeme(TTO)) {
-            base = parseBasicType(prefix, suffix);
+            base = currentSymbol == TRECORD ? parseType(prefix, suffix) : parseBasicType(prefix, suffix);
             strcat(prefix, " *");
-            tid = typesPtr++;
-            typeForm[tid] = 8;
-            typeBase[tid] = base;
+            tid = typeTableAdd(8, base, 0);
         } else {
             strcpy(prefix, "void ");
-            tid = typesPtr++;
-            typeForm[tid] = 8;
-            typeBase[tid] = 0;
+            tid = typeTableAdd(8, 0, 0);
         }
     } else if (checkLexeme(TARRAY)) {
-        int arrLen = parseArraySize(arrSizeBuf);
-        matchSymbol(TOF, "OF expected");
-        base = parseType(prefix, suffix);
-        strcpy(suffix, "[");
-        strcat(suffix, arrSizeBuf);
-        strcat(suffix, "]");
-        tid = typesPtr++;
-        typeForm[tid] = 7;
-        typeBase[tid] = base;
-        typeLen[tid] = arrLen;
+        if (checkLexeme(TOF)) {
+            if (!open) fatalError("Open array only allowed as parameter");
+            base = parseType(prefix, suffix);
+            if (base == 9) fatalError("Open array of PROCEDURE not supported");
+            tid = typeTableAdd(7, base, 0);
+        } else {
+            tid = parseArrayType(prefix, suffix);
+        }
     } else if (checkLexeme(TPROC)) {
         strcpy(prefix, "void (");
         strcpy(suffix, ")()");
         tid = 9;
+    } else if (checkLexeme(TRECORD)) {
+        sprintf(prefix, "%s_rec_%d", moduleName, ++recordCount);
+        bufferAppend(BUFH, "typedef struct ");
+        bufferAppend(BUFH, prefix);
+        bufferAppend(BUFH, " ");
+        bufferAppend(BUFH, prefix);
+        bufferAppend(BUFH, ";\n");
+        tid = parseRecord(prefix, -1);
     } else {
         tid = parseBasicType(prefix, suffix);
     }
@@ -764,103 +2473,869 @@ void printVariable(char *tgt, const char *name, const char *prefix, const char *
     strcat(tgt, suffix);
 }
 
+void printParameter(char *tgt, const char *name, int tid, int isVar, const char *prefix, const char *suffix) {
+    char buf[MAXTYPELEN + 4];
+    if (isOpenArray(tid) || (isVar && typeForm[tid] != 7)) {
+        strcpy(buf, prefix);
+        strcat(buf, suffix[0] ? " (*" : " *");
+        printVariable(tgt, name, buf, suffix[0] ? ")" : "");
+        strcat(tgt, suffix);
+    } else {
+        printVariable(tgt, name, prefix, suffix);
+    }
+    if (isOpenArray(tid)) {
+        strcat(tgt, ", long ");
+        strcat(tgt, moduleName);
+        strcat(tgt, "_");
+        strcat(tgt, name);
+        strcat(tgt, "_len");
+    }
+}
+
+void enterBlock(void) {
+    blockDepth++;
+}
+
+void leaveBlock(void) {
+    int i;
+    blockDepth--;
+    for (i = 0; i < symbolTablePtr; i++) {
+        if (symbolTableFact[i] > blockDepth + 1) symbolTableFact[i] = 0;
+    }
+}
+
+void noteAssignment(int v, int kind) {
+    int i;
+    for (i = 0; i < loopCount; i++) {
+        if (loopVar[i] == v) {
+            loopMods[i]++;
+            if (kind == 0) loopLowSafe[i] = 0;
+        }
+    }
+    if (kind == 0) symbolTableFact[v] = 0;
+    else if (kind == 1 && (symbolTableFact[v] == 0 || symbolTableFact[v] - 1 < loopFloor)) symbolTableFact[v] = blockDepth + 1;
+}
+
+void forgetGlobals(void) {
+    int i;
+    for (i = 0; i < loopCount; i++) {
+        if (loopVar[i] >= 0 && symbolTableLevel[loopVar[i]] == 0 && loopCounter[i] == 0) {
+            loopMods[i]++;
+            loopLowSafe[i] = 0;
+        }
+    }
+    for (i = 0; i < localStart; i++) {
+        if (symbolTableLevel[i] == 0) symbolTableFact[i] = 0;
+    }
+}
+
+void loopPush(int var, long bound, int open) {
+    if (loopCount >= loopCapacity) {
+        loopCapacity = loopCapacity ? loopCapacity * 2 : 16;
+        loopVar = (int *)growArray(loopVar, loopCapacity, sizeof(int));
+        loopBound = (long *)growArray(loopBound, loopCapacity, sizeof(long));
+        loopOpen = (int *)growArray(loopOpen, loopCapacity, sizeof(int));
+        loopMods = (int *)growArray(loopMods, loopCapacity, sizeof(int));
+        loopLowSafe = (int *)growArray(loopLowSafe, loopCapacity, sizeof(int));
+        loopFirstGuard = (int *)growArray(loopFirstGuard, loopCapacity, sizeof(int));
+        loopFloorSaved = (int *)growArray(loopFloorSaved, loopCapacity, sizeof(int));
+        loopCaseDepth = (int *)growArray(loopCaseDepth, loopCapacity, sizeof(int));
+        loopExit = (int *)growArray(loopExit, loopCapacity, sizeof(int));
+        loopFor = (int *)growArray(loopFor, loopCapacity, sizeof(int));
+        loopCounter = (int *)growArray(loopCounter, loopCapacity, sizeof(int));
+    }
+    loopVar[loopCount] = var;
+    loopBound[loopCount] = bound;
+    loopOpen[loopCount] = open;
+    loopMods[loopCount] = 0;
+    loopLowSafe[loopCount] = var >= 0 && symbolTableFact[var] > 0 && symbolTableFact[var] - 1 >= loopFloor;
+    loopFirstGuard[loopCount] = guardCount;
+    loopFloorSaved[loopCount] = loopFloor;
+    loopCaseDepth[loopCount] = caseDepth;
+    loopExit[loopCount] = 0;
+    loopFor[loopCount] = -1;
+    loopCounter[loopCount] = 0;
+    loopCount++;
+    enterBlock();
+    loopFloor = blockDepth;
+}
+
+int loopPop(void) {
+    int i;
+    loopCount--;
+    for (i = loopFirstGuard[loopCount]; i < guardCount; i++) {
+        if (guardState[i] == 2 && guardLoop[i] == loopCount) guardState[i] = loopLowSafe[loopCount] ? 1 : 0;
+        else if (guardState[i] == 2 && guardLoop[i] < loopCount && loopMods[guardLoop[i]] > 0) guardState[i] = 0;
+    }
+    loopFloor = loopFloorSaved[loopCount];
+    leaveBlock();
+    return loopExit[loopCount];
+}
+
+void emitLoopExit(int id) {
+    char buf[MAXIDLEN + 16];
+    if (id == 0) return;
+    sprintf(buf, "%s_exit_%d: ;\n", moduleName, id);
+    emitCode(buf);
+}
+
 void parseIncDec(int isInc) {
+    int target, kind = isInc ? 2 : 0;
     nextToken();
     matchSymbol(TLPAREN, "( expected");
     parseDesignator();
+    checkWritable();
+    target = plainVar;
     if (checkLexeme(TCOMMA)) {
         emitCode(isInc ? " += " : " -= ");
         parseExpression();
+        if (!exprConst || exprIntVal < 0) kind = 0;
     } else {
         emitCode(isInc ? "++" : "--");
     }
+    if (target >= 0) noteAssignment(target, kind);
     matchSymbol(TRPAREN, ") expected");
     emitCode(";\n");
 }
 
-void parseStatement(void) {
-    int t, t2;
-    if (currentSymbol == TIDENT) {
-        stmtLhsBuffer[0] = 0;
-        captureBuffer = stmtLhsBuffer;
-        t = parseDesignator();
-        captureBuffer = NULL;
-        if (checkLexeme(TASSIGN)) {
-            if (currentSymbol == TSTRING) {
-                fprintf(fileC, "strcpy(%s, %s)", stmtLhsBuffer, currentToken);
-                nextToken();
-            } else {
-                fprintf(fileC, "%s = ", stmtLhsBuffer);
-                t2 = parseExpression();
-                checkTypeCompatibility(t, t2);
-            }
-        } else if (currentSymbol == TLPAREN) {
-            fprintf(fileC, "%s", stmtLhsBuffer);
-            parseParameters();
-        } else {
-            fprintf(fileC, "%s()", stmtLhsBuffer);
-        }
-        emitCode(";\n");
-    } else if (checkLexeme(TIF)) {
-        emitCode("if (");
-        t = parseExpression();
-        checkTypeCompatibility(t, 5);
-        emitCode(") {\n");
-        matchSymbol(TTHEN, "THEN expected");
-        parseStatementSequence();
-        while (checkLexeme(TELSIF)) {
-            emitCode("} else if (");
-            t = parseExpression();
-            checkTypeCompatibility(t, 5);
-            emitCode(") {\n");
-            matchSymbol(TTHEN, "THEN expected");
-            parseStatementSequence();
-        }
-        if (checkLexeme(TELSE)) {
-            emitCode("} else {\n");
-            parseStatementSequence();
+void emitVecPointer(int i, const char *c, int restricted, long off, long end) {
+    char buf[MAXIDLEN * 2 + 48];
+    sprintf(buf, "%s%s *%s%s_vec_%c = (%s%s *)(", i ? "const " : "", c, restricted ? "restrict " : "", moduleName, "dab"[i], i ? "const " : "", c);
+    emitCode(buf);
+    emitCodeRange(bufferData[BUFARGS] + off, (int)(end - off));
+    emitCode(");\n");
+}
+
+void parseVecStatement(int op) {
+    int t, i, j, n = op == TVADD ? 3 : op == TVSCALE ? 2 : 1, zero = 0, alias = 0, root[3], direct[3], same[3];
+    long off[4], end[4];
+    char count[MAXIDLEN * 2 + 24], other[MAXIDLEN * 2 + 24], buf[MAXIDLEN * 10 + 64];
+    const char *c;
+    nextToken();
+    matchSymbol(TLPAREN, "( expected");
+    bufferReset(BUFARGS);
+    emitBuffer = BUFARGS;
+    for (i = 0; i < n; i++) {
+        if (i > 0) matchSymbol(TCOMMA, ", expected");
+        off[i] = bufferLen[BUFARGS];
+        if (i == 0) {
+            t = parseVecArray(op != TFILL, count);
+            checkWritable();
+        } else if (parseVecArray(1, other) != t || strcmp(count, other) != 0) {
+            fatalError("Arrays of equal length expected");
         }
-        matchSymbol(TEND, "END expected");
-        emitCode("}\n");
-    } else if (checkLexeme(TWHILE)) {
-        emitCode("while (");
-        t = parseExpression();
-        checkTypeCompatibility(t, 5);
-        emitCode(") {\n");
-        matchSymbol(TDO, "DO expected");
-        parseStatementSequence();
-        matchSymbol(TEND, "END expected");
-        emitCode("}\n");
-    } else if (checkLexeme(TREPEAT)) {
-        emitCode("do {\n");
-        parseStatementSequence();
-        emitCode("\n} while (!(\n");
-        matchSymbol(TUNTIL, "UNTIL expected");
-        t = parseExpression();
-        checkTypeCompatibility(t, 5);
-        emitCode("));\n");
-    } else if (checkLexeme(TRETURN)) {
-        emitCode("return ");
-        if (currentSymbol != TSEMICOL && currentSymbol != TEND && currentSymbol != TELSE && currentSymbol != TELSIF) {
-            parseExpression();
+        end[i] = bufferLen[BUFARGS];
+        root[i] = desRoot;
+        direct[i] = !desDeref && symbolTableType[desRoot] != TSYMPARAM && symbolTableType[desRoot] != TSYMVARPARAM;
+    }
+    if (op != TVADD) {
+        matchSymbol(TCOMMA, ", expected");
+        off[n] = bufferLen[BUFARGS];
+        checkTypeCompatibility(t, parseExpression());
+        end[n] = bufferLen[BUFARGS];
+        zero = exprConst && exprIntVal == 0 && exprRealVal == 0;
+    }
+    matchSymbol(TRPAREN, ") expected");
+    emitBuffer = BUFIR;
+    c = basicCName(t);
+    if (op == TFILL && (zero || t == 5 || t == 6)) {
+        emitCode("memset(");
+        emitCodeRange(bufferData[BUFARGS] + off[0], (int)(end[0] - off[0]));
+        emitCode(", ");
+        emitCodeRange(bufferData[BUFARGS] + off[1], (int)(end[1] - off[1]));
+        sprintf(buf, ", %s * sizeof(%s));\n", count, c);
+        emitCode(buf);
+        return;
+    }
+    for (i = 0; i < n; i++) {
+        same[i] = i;
+        for (j = 0; j < i && same[i] == i; j++) {
+            if (end[j] - off[j] == end[i] - off[i] && memcmp(bufferData[BUFARGS] + off[j], bufferData[BUFARGS] + off[i], end[i] - off[i]) == 0) same[i] = j;
         }
+        if (i > 0 && same[i] == i && (!direct[0] || !direct[i] || root[i] == root[0])) alias = 1;
+    }
+    emitCode("{\n");
+    for (i = 0; i < n; i++) {
+        if (same[i] == i) emitVecPointer(i, c, !alias, off[i], end[i]);
+    }
+    if (op != TVADD) {
+        sprintf(buf, "%s %s_vec_x = ", c, moduleName);
+        emitCode(buf);
+        emitCodeRange(bufferData[BUFARGS] + off[n], (int)(end[n] - off[n]));
         emitCode(";\n");
-    } else if (currentSymbol == TINC) {
-        parseIncDec(1);
-    } else if (currentSymbol == TDEC) {
-        parseIncDec(0);
-    } else if (checkLexeme(TBREAK)) {
-        emitCode("break;\n");
-    } else if (checkLexeme(TCONT)) {
-        emitCode("continue;\n");
+    }
+    sprintf(buf, "long %s_vec_i;\nfor (%s_vec_i = 0; %s_vec_i < %s; %s_vec_i++) %s_vec_d[%s_vec_i] = ",
+        moduleName, moduleName, moduleName, count, moduleName, moduleName, moduleName);
+    emitCode(buf);
+    for (i = 1; i < n; i++) {
+        sprintf(buf, "%s%s_vec_%c[%s_vec_i]", i > 1 ? " + " : "", moduleName, "dab"[same[i]], moduleName);
+        emitCode(buf);
+    }
+    if (op != TVADD) {
+        sprintf(buf, "%s%s_vec_x", op == TVSCALE ? " * " : "", moduleName);
+        emitCode(buf);
+    }
+    emitCode(";\n}\n");
+}
+
+void irBegin(void) {
+    bufferReset(BUFIR);
+    emitBuffer = BUFIR;
+    irCount = 0;
+    irPending = 0;
+    irPendingLine = 0;
+    guardCount = 0;
+    loopCount = 0;
+    loopFloor = 0;
+    blockDepth = 0;
+    caseDepth = 0;
+    forgetGlobals();
+}
+
+void irAdd(int kind) {
+    if (kind == IRRAW && bufferLen[BUFIR] == irPending) return;
+    if (irCount >= irCapacity) {
+        irCapacity = irCapacity ? irCapacity * 2 : STABSIZE;
+        irKind = (int *)growArray(irKind, irCapacity, sizeof(int));
+        irStart = (long *)growArray(irStart, irCapacity, sizeof(long));
+        irEnd = (long *)growArray(irEnd, irCapacity, sizeof(long));
+        irValue = (int *)growArray(irValue, irCapacity, sizeof(int));
+        irLine = (int *)growArray(irLine, irCapacity, sizeof(int));
+        irBranch = (int *)growArray(irBranch, irCapacity, sizeof(int));
+    }
+    irKind[irCount] = kind;
+    irStart[irCount] = irPending;
+    irEnd[irCount] = bufferLen[BUFIR];
+    irValue[irCount] = exprConst ? exprIntVal != 0 : -1;
+    irLine[irCount] = irPendingLine;
+    irBranch[irCount] = -1;
+    if (kind == IRIF || kind == IRELSIF || kind == IRWHILE || kind == IRUNTIL) {
+        if (branchCount >= branchCapacity) {
+            branchCapacity = branchCapacity ? branchCapacity * 2 : STABSIZE;
+            branchLine = (int *)growArray(branchLine, branchCapacity, sizeof(int));
+            branchMulti = (int *)growArray(branchMulti, branchCapacity, sizeof(int));
+        }
+        branchLine[branchCount] = irPendingLine;
+        branchMulti[branchCount] = kind == IRELSIF;
+        irBranch[irCount] = branchCount++;
+    }
+    irPending = bufferLen[BUFIR];
+    irPendingLine = 0;
+    irCount++;
+}
+
+void irMark(void) {
+    irPendingLine = currentLine;
+}
+
+void irAddStatement(int kind) {
+    if (bufferLen[BUFHOIST] > 0) emitInsert(irPending, bufferData[BUFHOIST]);
+    irAdd(kind);
+}
+
+void irEmitGuarded(int b, const char *p, const char *end) {
+    const char *q;
+    int id;
+    char buf[MAXIDLEN * 4];
+    while (p < end) {
+        q = p;
+        while (q < end && *q != '\001' && *q != '\002') q++;
+        bufferAppendRange(b, p, (long)(q - p));
+        if (q == end) break;
+        id = atoi(q + 1);
+        if (guardState[id] == 0 && *q == '\001') {
+            sprintf(buf, "%s_IDX(", moduleName);
+            bufferAppend(b, buf);
+        } else if (guardState[id] == 0) {
+            formatGuard(buf, id);
+            bufferAppend(b, buf);
+            bufferAppend(b, ")");
+        }
+        p = strchr(q, ';') + 1;
+    }
+}
+
+int emitBranchOpen(int b, int id) {
+    char buf[MAXIDLEN + 32];
+    if (profMode == 3) {
+        sprintf(buf, "Prof_Branch(%s_prof_br + %d, ", moduleName, id * 2);
+    } else if (!profileMatched || branchMulti[id] || id >= profileBranches || profileTotal[id] < PROFMINCOUNT) {
+        return 0;
+    } else if (profileTaken[id] * 10 >= profileTotal[id] * 9) {
+        sprintf(buf, "%s_LIKELY(", moduleName);
+    } else if (profileTaken[id] * 10 <= profileTotal[id]) {
+        sprintf(buf, "%s_UNLIKELY(", moduleName);
+    } else {
+        return 0;
+    }
+    bufferAppend(b, buf);
+    return 1;
+}
+
+void irEmitText(int i, const char *pre, const char *suf) {
+    int b = linesMode ? BUFLINES : BUFC;
+    int wrapped;
+    if (linesMode) bufferReset(BUFLINES);
+    bufferAppend(b, pre);
+    wrapped = irBranch[i] >= 0 && emitBranchOpen(b, irBranch[i]);
+    if (guardCount > 0) irEmitGuarded(b, bufferData[BUFIR] + irStart[i], bufferData[BUFIR] + irEnd[i]);
+    else bufferAppendRange(b, bufferData[BUFIR] + irStart[i], irEnd[i] - irStart[i]);
+    if (wrapped) bufferAppend(b, ")");
+    bufferAppend(b, suf);
+    if (linesMode) lineCopy(bufferData[BUFLINES], irLine[i], irKind[i] != IRRAW);
+}
+
+int irCondition(int i) {
+    if (irKind[i] == IRELSE) return 1;
+    return optimizeMode ? irValue[i] : -1;
+}
+
+int irEmitBlock(int i, int live);
+
+int irEmitIf(int i, int live) {
+    int opened = 0, taken = 0, v;
+    while (irKind[i] != IREND) {
+        v = irCondition(i);
+        if (taken || v == 0) {
+            i = irEmitBlock(i + 1, 0);
+            continue;
+        }
+        if (v == 1) {
+            if (live && opened) bufferAppend(BUFC, "} else {\n");
+            taken = 1;
+        } else if (opened) {
+            if (live) irEmitText(i, "} else if (", ") {\n");
+        } else {
+            if (live) irEmitText(i, "if (", ") {\n");
+            opened = 1;
+        }
+        i = irEmitBlock(i + 1, live);
+    }
+    if (live && opened) bufferAppend(BUFC, "}\n");
+    return i + 1;
+}
+
+int caseTarget(int c, long v) {
+    int j;
+    for (j = caseFirst[c]; j < caseEnd[c]; j++) {
+        if (caseOf[j] == c && v >= caseLow[j] && v <= caseHigh[j]) return caseArm[j];
+    }
+    return -1;
+}
+
+void caseLabel(int c, int arm) {
+    char buf[MAXIDLEN + 32];
+    if (arm < 0) sprintf(buf, "%s_case_%d_d:\n", moduleName, c);
+    else sprintf(buf, "%s_case_%d_%d:\n", moduleName, c, arm);
+    bufferAppend(BUFC, buf);
+}
+
+int irEmitCaseGoto(int i, int live) {
+    int c = irValue[i], hasElse = 0, j;
+    long v, lo = caseLow[caseFirst[c]], hi = lo;
+    char buf[MAXIDLEN * 4 + 128];
+    for (j = caseFirst[c]; j < caseEnd[c]; j++) {
+        if (caseOf[j] != c) continue;
+        if (caseLow[j] < lo) lo = caseLow[j];
+        if (caseHigh[j] > hi) hi = caseHigh[j];
+    }
+    if (live) {
+        sprintf(buf, "{\nstatic void *const %s_case_%d[] = {", moduleName, c);
+        bufferAppend(BUFC, buf);
+        for (v = lo; v <= hi; v++) {
+            if (v > lo) bufferAppend(BUFC, (v - lo) % 8 == 0 ? ",\n" : ", ");
+            if (caseTarget(c, v) < 0) sprintf(buf, "&&%s_case_%d_d", moduleName, c);
+            else sprintf(buf, "&&%s_case_%d_%d", moduleName, c, caseTarget(c, v));
+            bufferAppend(BUFC, buf);
+        }
+        bufferAppend(BUFC, "};\n");
+        sprintf(buf, "unsigned long %s_case_%d_v = (unsigned long)((long)(", moduleName, c);
+        irEmitText(i, buf, "");
+        sprintf(buf, ") - %ld);\nif (%s_case_%d_v > %ldUL) goto %s_case_%d_d;\ngoto *%s_case_%d[%s_case_%d_v];\n",
+            lo, moduleName, c, hi - lo, moduleName, c, moduleName, c, moduleName, c);
+        bufferAppend(BUFC, buf);
+    }
+    i++;
+    while (irKind[i] != IREND) {
+        hasElse = hasElse || irValue[i] < 0;
+        if (live) caseLabel(c, irValue[i]);
+        i = irEmitBlock(i + 1, live);
+        sprintf(buf, "goto %s_case_%d_e;\n", moduleName, c);
+        if (live) bufferAppend(BUFC, buf);
+    }
+    if (live) {
+        if (!hasElse) {
+            caseLabel(c, -1);
+            bufferAppend(BUFC, "abort();\n");
+        }
+        sprintf(buf, "%s_case_%d_e: ;\n}\n", moduleName, c);
+        bufferAppend(BUFC, buf);
+    }
+    return i + 1;
+}
+
+int irEmitCaseIf(int i, int live) {
+    int c = irValue[i], arm = 0, hasElse = 0, first, j;
+    char buf[MAXIDLEN * 2 + 96];
+    if (live) {
+        sprintf(buf, "{\nlong %s_case_%d_v = (long)(", moduleName, c);
+        irEmitText(i, buf, ");\n");
+    }
+    i++;
+    while (irKind[i] != IREND) {
+        hasElse = hasElse || irValue[i] < 0;
+        if (live && irValue[i] < 0) {
+            bufferAppend(BUFC, arm ? "} else {\n" : "{\n");
+        } else if (live) {
+            bufferAppend(BUFC, arm ? "} else if (" : "if (");
+            first = 1;
+            for (j = caseFirst[c]; j < caseEnd[c]; j++) {
+                if (caseOf[j] != c || caseArm[j] != irValue[i]) continue;
+                if (!first) bufferAppend(BUFC, " || ");
+                if (caseLow[j] == caseHigh[j]) sprintf(buf, "%s_case_%d_v == %ld", moduleName, c, caseLow[j]);
+                else sprintf(buf, "(%s_case_%d_v >= %ld && %s_case_%d_v <= %ld)", moduleName, c, caseLow[j], moduleName, c, caseHigh[j]);
+                bufferAppend(BUFC, buf);
+                first = 0;
+            }
+            bufferAppend(BUFC, ") {\n");
+        }
+        arm++;
+        i = irEmitBlock(i + 1, live);
+    }
+    if (live && !hasElse) bufferAppend(BUFC, arm ? "} else {\nabort();\n" : "abort();\n");
+    if (live && arm) bufferAppend(BUFC, "}\n");
+    if (live && caseBreak[c]) {
+        sprintf(buf, "%s_case_%d_e: ;\n", moduleName, c);
+        bufferAppend(BUFC, buf);
+    }
+    if (live) bufferAppend(BUFC, "}\n");
+    return i + 1;
+}
+
+int irEmitCase(int i, int live) {
+    int c = irValue[i], hasElse = 0, j;
+    long v;
+    char buf[MAXIDLEN + 32];
+    if (caseForm[c] == CASETABLE) return irEmitCaseGoto(i, live);
+    if (caseForm[c] == CASEIF) return irEmitCaseIf(i, live);
+    if (live) irEmitText(i, "switch (", ") {\n");
+    i++;
+    while (irKind[i] != IREND) {
+        hasElse = hasElse || irValue[i] < 0;
+        if (live && irValue[i] < 0) bufferAppend(BUFC, "default:\n");
+        for (j = caseFirst[c]; live && j < caseEnd[c]; j++) {
+            if (caseOf[j] != c || caseArm[j] != irValue[i]) continue;
+            for (v = caseLow[j]; v <= caseHigh[j]; v++) {
+                sprintf(buf, v < caseHigh[j] && (v - caseLow[j]) % 8 != 7 ? "case %ld: " : "case %ld:\n", v);
+                bufferAppend(BUFC, buf);
+            }
+        }
+        i = irEmitBlock(i + 1, live);
+        if (live) bufferAppend(BUFC, "break;\n");
+    }
+    if (live && !hasElse) bufferAppend(BUFC, "default:\nabort();\n");
+    if (live) bufferAppend(BUFC, "}\n");
+    if (live && caseBreak[c]) {
+        sprintf(buf, "%s_case_%d_e: ;\n", moduleName, c);
+        bufferAppend(BUFC, buf);
+    }
+    return i + 1;
+}
+
+int irEmitBlock(int i, int live) {
+    int k, loop, reachable = live;
+    while (i < irCount) {
+        k = irKind[i];
+        if (k == IRELSIF || k == IRELSE || k == IREND || k == IRUNTIL || k == IRLABEL) break;
+        if (k == IRRAW) {
+            if (live) irEmitText(i, "", "");
+            i++;
+        } else if (k == IRSTMT || k == IRJUMP) {
+            if (reachable) irEmitText(i, "", "");
+            if (k == IRJUMP && optimizeMode) reachable = 0;
+            i++;
+        } else if (k == IRIF) {
+            i = irEmitIf(i, reachable);
+        } else if (k == IRCASE) {
+            i = irEmitCase(i, reachable);
+        } else if (k == IRFOR) {
+            loop = irValue[i];
+            if (reachable) irEmitText(i, "", ") {\n");
+            i = irEmitBlock(i + 1, reachable);
+            if (reachable && loop == 2) irEmitText(i, "}\n", "}\n");
+            else if (reachable) bufferAppend(BUFC, loop ? "}\n}\n" : "}\n");
+            i++;
+        } else if (k == IRWHILE) {
+            loop = reachable && irCondition(i) != 0;
+            if (loop) irEmitText(i, "while (", ") {\n");
+            i = irEmitBlock(i + 1, loop);
+            if (loop) bufferAppend(BUFC, "}\n");
+            i++;
+        } else {
+            if (reachable) bufferAppend(BUFC, "do {\n");
+            i = irEmitBlock(i + 1, reachable);
+            if (reachable) irEmitText(i, linesMode ? "} while (!(" : "\n} while (!(\n", "));\n");
+            i++;
+        }
+    }
+    return i;
+}
+
+void irFinish(void) {
+    double t = statsMode ? statsNow() : 0;
+    irAdd(IRRAW);
+    emitBuffer = BUFC;
+    irEmitBlock(0, 1);
+    if (linesMode) lineRestore();
+    irCount = 0;
+    bufferReset(BUFIR);
+    if (statsMode) statsEmit += statsNow() - t;
+}
+
+void caseLabelAdd(int c, long lo, long hi, int arm) {
+    int j;
+    if (hi < lo) fatalError("Empty CASE range");
+    for (j = caseFirst[c]; j < caseLabelCount; j++) {
+        if (caseOf[j] == c && lo <= caseHigh[j] && hi >= caseLow[j]) fatalError("Duplicate CASE label");
+    }
+    if (caseLabelCount >= caseLabelCapacity) {
+        caseLabelCapacity = caseLabelCapacity ? caseLabelCapacity * 2 : 64;
+        caseLow = (long *)growArray(caseLow, caseLabelCapacity, sizeof(long));
+        caseHigh = (long *)growArray(caseHigh, caseLabelCapacity, sizeof(long));
+        caseArm = (int *)growArray(caseArm, caseLabelCapacity, sizeof(int));
+        caseOf = (int *)growArray(caseOf, caseLabelCapacity, sizeof(int));
+    }
+    caseLow[caseLabelCount] = lo;
+    caseHigh[caseLabelCount] = hi;
+    caseArm[caseLabelCount] = arm;
+    caseOf[caseLabelCount] = c;
+    caseLabelCount++;
+}
+
+void parseCase(void) {
+    int t, c, j, arm = 0, outer = caseInner, wide = 0;
+    long lo = 0, hi = 0, n = 0, start;
+    irAdd(IRRAW);
+    start = bufferLen[emitBuffer];
+    t = parseExpression();
+    if (t != 1 && t != 2 && t != 6) fatalError("Integer or CHAR expected");
+    if (t == 6) {
+        emitInsert(start, "(unsigned char)(");
+        emitCode(")");
+    }
+    if (caseCount >= caseCapacity) {
+        caseCapacity = caseCapacity ? caseCapacity * 2 : 16;
+        caseFirst = (int *)growArray(caseFirst, caseCapacity, sizeof(int));
+        caseEnd = (int *)growArray(caseEnd, caseCapacity, sizeof(int));
+        caseForm = (int *)growArray(caseForm, caseCapacity, sizeof(int));
+        caseBreak = (int *)growArray(caseBreak, caseCapacity, sizeof(int));
+    }
+    c = caseCount++;
+    caseFirst[c] = caseLabelCount;
+    caseBreak[c] = 0;
+    caseInner = c;
+    irAdd(IRCASE);
+    irValue[irCount - 1] = c;
+    matchSymbol(TOF, "OF expected");
+    caseDepth++;
+    do {
+        if (currentSymbol == TBAR || currentSymbol == TELSE || currentSymbol == TEND) continue;
+        do {
+            checkTypeCompatibility(t, parseConstExpression());
+            lo = exprIntVal;
+            if (checkLexeme(TUPTO)) checkTypeCompatibility(t, parseConstExpression());
+            caseLabelAdd(c, lo, exprIntVal, arm);
+        } while (checkLexeme(TCOMMA));
+        matchSymbol(TCOLON, ": expected");
+        irAdd(IRRAW);
+        irAdd(IRLABEL);
+        irValue[irCount - 1] = arm++;
+        enterBlock();
+        parseStatementSequence();
+        leaveBlock();
+    } while (checkLexeme(TBAR));
+    if (checkLexeme(TELSE)) {
+        irAdd(IRRAW);
+        irAdd(IRLABEL);
+        irValue[irCount - 1] = -1;
+        enterBlock();
+        parseStatementSequence();
+        leaveBlock();
+    }
+    caseDepth--;
+    caseInner = outer;
+    matchSymbol(TEND, "END expected");
+    irAdd(IRRAW);
+    irAdd(IREND);
+    caseEnd[c] = caseLabelCount;
+    for (j = caseFirst[c]; j < caseEnd[c]; j++) {
+        if (caseOf[j] != c) continue;
+        if (n == 0 || caseLow[j] < lo) lo = caseLow[j];
+        if (n == 0 || caseHigh[j] > hi) hi = caseHigh[j];
+        n += caseHigh[j] - caseLow[j] + 1;
+        wide = wide || caseHigh[j] - caseLow[j] >= MAXCASERANGE;
+    }
+    if (gotoMode && n >= MINDENSECASE && hi - lo < 2 * n && hi - lo < MAXCASERANGE) caseForm[c] = CASETABLE;
+    else caseForm[c] = wide ? CASEIF : CASESWITCH;
+}
+
+void parseFor(void) {
+    int t, var, plain, lowConst, lowPred, highConst, highPred, open, safe, exit, counter;
+    long node, start, step = 1, low, high, bound;
+    char name[MAXIDLEN * 2 + 8], store[MAXIDLEN * 4 + 16], limit[MAXIDLEN + 16], buf[MAXIDLEN * 6 + 64];
+    irAdd(IRRAW);
+    node = bufferLen[BUFIR];
+    if (currentSymbol != TIDENT) fatalError("Identifier expected");
+    bufferReset(BUFLHS);
+    emitBuffer = BUFLHS;
+    t = parseDesignator();
+    emitBuffer = BUFIR;
+    var = desVar;
+    plain = plainVar;
+    if (var < 0 || desReadOnly || symbolTableType[var] == TSYMVARPARAM || symbolTableType[var] == TSYMCONST) fatalError("FOR variable expected");
+    if (t != 1 && t != 2) fatalError("Integer expected");
+    counter = symbolTableLevel[var] == 0 ? forCount + 1 : 0;
+    strcpy(name, bufferData[BUFLHS]);
+    sprintf(limit, "%s_for_%d", moduleName, ++forCount);
+    if (counter) {
+        sprintf(store, "%s = %s_i;\n", name, limit);
+        sprintf(name, "%s_i", limit);
+    }
+    matchSymbol(TASSIGN, ":= expected");
+    emitCode("for (");
+    emitCode(name);
+    emitCode(" = ");
+    checkTypeCompatibility(t, parseExpression());
+    lowConst = exprConst;
+    low = exprIntVal;
+    lowPred = lenPredOpen;
+    matchSymbol(TTO, "TO expected");
+    emitCode(", ");
+    emitCode(limit);
+    emitCode(" = ");
+    start = bufferLen[BUFIR];
+    checkTypeCompatibility(t, parseExpression());
+    highConst = exprConst;
+    high = exprIntVal;
+    highPred = lenPredOpen;
+    if (highConst) {
+        bufferDelete(BUFIR, start - strlen(limit) - 5, bufferLen[BUFIR] - start + strlen(limit) + 5);
+        sprintf(limit, "%ld", high);
+        if (counter) sprintf(buf, "{\n%s %s;\n", t == 1 ? "int" : "long", name);
+    } else if (counter) {
+        sprintf(buf, "{\n%s %s, %s;\n", t == 1 ? "int" : "long", name, limit);
+    } else {
+        sprintf(buf, "{\n%s %s;\n", t == 1 ? "int" : "long", limit);
+    }
+    if (!highConst || counter) emitInsert(node, buf);
+    if (checkLexeme(TBY)) {
+        checkTypeCompatibility(t, parseConstExpression());
+        step = exprIntVal;
+        if (step == 0) fatalError("FOR step must not be zero");
+    }
+    if (step == 1) sprintf(buf, "; %s <= %s; %s++", name, limit, name);
+    else if (step == -1) sprintf(buf, "; %s >= %s; %s--", name, limit, name);
+    else sprintf(buf, "; %s %s %s; %s += %ld", name, step > 0 ? "<=" : ">=", limit, name, step);
+    emitCode(buf);
+    irAdd(IRFOR);
+    irValue[irCount - 1] = counter ? 2 : !highConst;
+    if (counter) emitCode(store);
+    matchSymbol(TDO, "DO expected");
+    if (step > 0) {
+        safe = lowConst && low >= 0;
+        bound = highConst ? high + 1 : 0;
+        open = highConst ? -1 : highPred;
+    } else {
+        safe = highConst && high >= 0;
+        bound = lowConst ? low + 1 : 0;
+        open = lowConst ? -1 : lowPred;
+    }
+    if (plain >= 0) noteAssignment(plain, safe);
+    loopPush(bound > 0 || open >= 0 ? plain : -1, bound, open);
+    loopFor[loopCount - 1] = var;
+    loopCounter[loopCount - 1] = counter;
+    parseStatementSequence();
+    exit = loopPop();
+    if (plain >= 0 && step < 0) noteAssignment(plain, 0);
+    matchSymbol(TEND, "END expected");
+    irAdd(IRRAW);
+    if (counter) emitCode(store);
+    irAdd(IREND);
+    emitLoopExit(exit);
+}
+
+void parseStatement(void) {
+    int t, t2, target, root, direct, head, exit, calls;
+    long start;
+    irAdd(IRRAW);
+    irMark();
+    checkedCount = 0;
+    bufferReset(BUFCHECK);
+    bufferReset(BUFHOIST);
+    hoistAllowed = currentSymbol == TIDENT || currentSymbol == TINC || currentSymbol == TDEC || currentSymbol == TRETURN;
+    if (currentSymbol == TIDENT) {
+        bufferReset(BUFLHS);
+        emitBuffer = BUFLHS;
+        t = parseDesignator();
+        target = plainVar;
+        emitBuffer = BUFIR;
+        if (checkLexeme(TASSIGN)) {
+            checkWritable();
+            if (currentSymbol == TSTRING) {
+                emitCode("strcpy(");
+                emitCode(bufferData[BUFLHS]);
+                emitCode(", ");
+                emitCode(currentToken);
+                emitCode(")");
+                nextToken();
+            } else if (typeForm[t] == 7) {
+                if (isOpenArray(t)) fatalError("Fixed-length array expected");
+                root = desRoot;
+                direct = !desDeref && symbolTableType[root] != TSYMPARAM && symbolTableType[root] != TSYMVARPARAM;
+                start = bufferLen[BUFIR];
+                emitCode(bufferData[BUFLHS]);
+                emitCode(", ");
+                checkSameType(t, parseExpression());
+                direct = direct && !desDeref && symbolTableType[desRoot] != TSYMPARAM && symbolTableType[desRoot] != TSYMVARPARAM;
+                emitInsert(start, direct && desRoot != root ? "memcpy(" : "memmove(");
+                sprintf(curOneArg, ", %d * sizeof(*", typeLen[t]);
+                emitCode(curOneArg);
+                emitCode(bufferData[BUFLHS]);
+                emitCode("))");
+            } else {
+                emitCode(bufferData[BUFLHS]);
+                emitCode(" = ");
+                t2 = parseExpression();
+                checkTypeCompatibility(t, t2);
+                if (target >= 0) noteAssignment(target, exprConst && exprIntVal >= 0);
+            }
+        } else if (currentSymbol == TLPAREN) {
+            noteCall(desVar);
+            emitCode(bufferData[BUFLHS]);
+            parseParameters(t);
+        } else {
+            noteCall(desVar);
+            checkParameterCount(t, 0);
+            emitCode(bufferData[BUFLHS]);
+            emitCode("()");
+        }
+        emitCode(";\n");
+        irAddStatement(IRSTMT);
+    } else if (checkLexeme(TIF)) {
+        irAdd(IRRAW);
+        t = parseExpression();
+        checkTypeCompatibility(t, 5);
+        irAdd(IRIF);
+        head = irBranch[irCount - 1];
+        matchSymbol(TTHEN, "THEN expected");
+        enterBlock();
+        parseStatementSequence();
+        leaveBlock();
+        while (checkLexeme(TELSIF)) {
+            irAdd(IRRAW);
+            irMark();
+            t = parseExpression();
+            checkTypeCompatibility(t, 5);
+            irAdd(IRELSIF);
+            branchMulti[head] = 1;
+            matchSymbol(TTHEN, "THEN expected");
+            enterBlock();
+            parseStatementSequence();
+            leaveBlock();
+        }
+        if (checkLexeme(TELSE)) {
+            irAdd(IRRAW);
+            irAdd(IRELSE);
+            enterBlock();
+            parseStatementSequence();
+            leaveBlock();
+        }
+        matchSymbol(TEND, "END expected");
+        irAdd(IRRAW);
+        irAdd(IREND);
+    } else if (checkLexeme(TWHILE)) {
+        irAdd(IRRAW);
+        loopHeader++;
+        calls = callCount;
+        t = parseExpression();
+        loopHeader--;
+        checkTypeCompatibility(t, 5);
+        if (calls != callCount && relVar >= 0 && symbolTableLevel[relVar] == 0) relVar = -1;
+        irAdd(IRWHILE);
+        loopPush(relVar, relBound, relOpen);
+        matchSymbol(TDO, "DO expected");
+        parseStatementSequence();
+        exit = loopPop();
+        matchSymbol(TEND, "END expected");
+        irAdd(IRRAW);
+        irAdd(IREND);
+        emitLoopExit(exit);
+    } else if (checkLexeme(TCASE)) {
+        parseCase();
+    } else if (checkLexeme(TFOR)) {
+        parseFor();
+    } else if (checkLexeme(TREPEAT)) {
+        irAdd(IRRAW);
+        irAdd(IRREPEAT);
+        loopPush(-1, 0, -1);
+        parseStatementSequence();
+        irAdd(IRRAW);
+        irMark();
+        matchSymbol(TUNTIL, "UNTIL expected");
+        t = parseExpression();
+        checkTypeCompatibility(t, 5);
+        exit = loopPop();
+        irAdd(IRUNTIL);
+        emitLoopExit(exit);
+    } else if (checkLexeme(TRETURN)) {
+        irAdd(IRRAW);
+        emitCode("return ");
+        if (currentSymbol != TSEMICOL && currentSymbol != TEND && currentSymbol != TELSE && currentSymbol != TELSIF && currentSymbol != TUNTIL && currentSymbol != TBAR) {
+            parseExpression();
+        }
+        emitCode(";\n");
+        irAddStatement(IRJUMP);
+    } else if (currentSymbol == TINC) {
+        parseIncDec(1);
+        irAddStatement(IRSTMT);
+    } else if (currentSymbol == TDEC) {
+        parseIncDec(0);
+        irAddStatement(IRSTMT);
+    } else if (currentSymbol == TFILL || currentSymbol == TVADD || currentSymbol == TVSCALE) {
+        parseVecStatement(currentSymbol);
+        irAddStatement(IRSTMT);
+    } else if (currentSymbol == TFASSERT) {
+        parseUnaryFunc("if (!(", ")) abort();\n", 5, 0);
+        irAddStatement(IRSTMT);
+    } else if (checkLexeme(TBREAK)) {
+        irAdd(IRRAW);
+        if (loopCount > 0 && loopCaseDepth[loopCount - 1] < caseDepth) {
+            if (loopExit[loopCount - 1] == 0) loopExit[loopCount - 1] = ++exitCount;
+            sprintf(curOneArg, "goto %s_exit_%d;\n", moduleName, loopExit[loopCount - 1]);
+            emitCode(curOneArg);
+        } else if (loopCount == 0 && caseDepth > 0) {
+            caseBreak[caseInner] = 1;
+            sprintf(curOneArg, "goto %s_case_%d_e;\n", moduleName, caseInner);
+            emitCode(curOneArg);
+        } else {
+            emitCode("break;\n");
+        }
+        irAdd(IRJUMP);
+    } else if (checkLexeme(TCONT)) {
+        irAdd(IRRAW);
+        emitCode("continue;\n");
+        irAdd(IRJUMP);
+    } else if (currentSymbol != TSEMICOL) {
+        fatalError("Statement expected");
     }
 }
 
 void parseStatementSequence(void) {
-    while (currentSymbol != TEND && currentSymbol != TELSIF && currentSymbol != TELSE) {
+    while (currentSymbol != TEND && currentSymbol != TELSIF && currentSymbol != TELSE && currentSymbol != TUNTIL && currentSymbol != TBAR && currentSymbol != TEOF) {
         parseStatement();
         checkLexeme(TSEMICOL);
     }
+    hoistAllowed = 0;
 }
 
 void parseVariableDeclaration(void) {
@@ -871,7 +3346,7 @@ void parseVariableDeclaration(void) {
         do {
             consumeIdentifier(varDeclId);
             isExported = checkLexeme(TMUL);
-            if (symbolTableFind(varDeclId)) fatalError("Duplicate identifier");
+            if (symbolTableFindInScope(varDeclId)) fatalError("Duplicate identifier");
             symbolTableAdd(varDeclId, isExported, isExported ? TSYMGEVAR : TSYMGVAR, 0);
         } while (checkLexeme(TCOMMA));
         matchSymbol(TCOLON, ": expected");
@@ -882,102 +3357,352 @@ void parseVariableDeclaration(void) {
             printVariable(varDeclBuf, &symbolTableNameBuffer[symbolTable[i]], varDeclPrefix, varDeclSuffix);
             if (isGlobalDefinition) {
                 if (symbolTableType[i] == TSYMGEVAR) {
-                    fprintf(fileC, "%s;\n", varDeclBuf);
-                    fprintf(fileHeader, "extern %s;\n", varDeclBuf);
+                    bufferAppend(BUFH, "extern ");
+                    bufferAppend(BUFH, varDeclBuf);
+                    bufferAppend(BUFH, ";\n");
                 } else if (symbolTableType[i] == TSYMGVAR) {
-                    fprintf(fileC, "static %s;\n", varDeclBuf);
+                    bufferAppend(BUFC, "static ");
                 }
-            } else {
-                fprintf(fileC, "%s;\n", varDeclBuf);
             }
+            bufferAppend(BUFC, varDeclBuf);
+            bufferAppend(BUFC, ";\n");
         }
     }
 }
 
-void parseProcedureHeader(int *savedSymbolTablePtr, int *savedSymbolTableNameBufferPtr) {
-    int exp = 0, i;
-    int startSymbolTablePtr;
-    int tid;
-    curArgList[0] = 0;
+long emitProcedureSignature(int b, const char *suffix) {
+    long pos;
+    bufferAppend(b, curRetPrefix);
+    bufferAppend(b, " ");
+    bufferAppend(b, moduleName);
+    bufferAppend(b, "_");
+    bufferAppend(b, curProcName);
+    pos = bufferLen[b];
+    bufferAppend(b, suffix);
+    bufferAppend(b, "(");
+    bufferAppend(b, bufferData[BUFARGS]);
+    bufferAppend(b, ")");
+    bufferAppend(b, curRetSuffix);
+    return pos;
+}
+
+void loadProfile(const char *name) {
+    FILE *f;
+    long size;
+    char *p;
+    char buf[MAXIDLEN * 4];
+    double calls;
+    f = fopen(name, "rb");
+    if (!f) {
+        diagnostic("Error: Cannot open %s\n", name);
+        stopTranslation();
+    }
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (profileData) free(profileData);
+    profileData = (char *)malloc(size + 1);
+    if (!profileData) fatalError("Out of memory");
+    size = (long)fread(profileData, 1, size, f);
+    fclose(f);
+    profileData[size] = 0;
+    profileMaxCalls = 0;
+    for (p = profileData; p; p = strchr(p, '\n')) {
+        if (*p == '\n') p++;
+        if (sscanf(p, "P %127s %lf", buf, &calls) == 2 && calls > profileMaxCalls) profileMaxCalls = calls;
+    }
+}
+
+void loadModuleProfile(void) {
+    char *p;
+    char buf[MAXIDLEN * 4];
+    unsigned long h;
+    int id, line, found = 0;
+    double total, taken;
+    profileMatched = 0;
+    profileBranches = 0;
+    if (!profileData) return;
+    for (p = profileData; p; p = strchr(p, '\n')) {
+        if (*p == '\n') p++;
+        if (sscanf(p, "M %127s %lx", buf, &h) == 2 && strcmp(buf, moduleName) == 0) {
+            found = 1;
+            profileMatched = h == moduleHash;
+        } else if (sscanf(p, "B %127s %d %d %lf %lf", buf, &id, &line, &total, &taken) == 5 && strcmp(buf, moduleName) == 0 && id >= 0) {
+            while (id >= profileCapacity) {
+                profileCapacity = profileCapacity ? profileCapacity * 2 : STABSIZE;
+                profileTotal = (double *)growArray(profileTotal, profileCapacity, sizeof(double));
+                profileTaken = (double *)growArray(profileTaken, profileCapacity, sizeof(double));
+            }
+            while (profileBranches <= id) {
+                profileTotal[profileBranches] = 0;
+                profileTaken[profileBranches++] = 0;
+            }
+            profileTotal[id] = total;
+            profileTaken[id] = taken;
+        }
+    }
+    if (found && !profileMatched) diagnostic("Warning: %s: profile does not match the source, ignored\n", sourceFileName);
+}
+
+double profileCalls(void) {
+    char *p;
+    char buf[MAXIDLEN * 4], name[MAXIDLEN * 2 + 2];
+    double calls;
+    if (!profileMatched) return -1;
+    sprintf(name, "%s.%s", moduleName, curProcName);
+    for (p = profileData; p; p = strchr(p, '\n')) {
+        if (*p == '\n') p++;
+        if (sscanf(p, "P %127s %lf", buf, &calls) == 2 && strcmp(buf, name) == 0) return calls;
+    }
+    return -1;
+}
+
+void parseProcedureHeader(void) {
+    int exp = 0, i, isVar;
+    int startSymbolTablePtr, procIndex;
+    int tid, retType = 0;
+    double calls;
+    bufferReset(BUFARGS);
     curRetPrefix[0] = 0;
     curRetSuffix[0] = 0;
     strcpy(curRetPrefix, "void");
     consumeIdentifier(curProcName);
     exp = checkLexeme(TMUL);
-    symbolTableAdd(curProcName, 0, TSYMPROC, 0);
-    *savedSymbolTablePtr = symbolTablePtr;
-    *savedSymbolTableNameBufferPtr = symbolTableNameBufferPtr;
+    procIndex = symbolTableAdd(curProcName, exp, TSYMPROC, 0);
+    if (profMode) {
+        if (profProcCount >= profProcCapacity) {
+            profProcCapacity = profProcCapacity ? profProcCapacity * 2 : 64;
+            profSig = (long *)growArray(profSig, profProcCapacity, sizeof(long));
+            profBody = (long *)growArray(profBody, profProcCapacity, sizeof(long));
+            profWrap = (long *)growArray(profWrap, profProcCapacity, sizeof(long));
+            profSplit = (long *)growArray(profSplit, profProcCapacity, sizeof(long));
+            profExp = (int *)growArray(profExp, profProcCapacity, sizeof(int));
+            profHot = (int *)growArray(profHot, profProcCapacity, sizeof(int));
+            profLeaf = (int *)growArray(profLeaf, profProcCapacity, sizeof(int));
+        }
+        profHot[profProcCount] = profMode != 1;
+        symbolTableIntValue[procIndex] = ++profProcCount;
+    }
+    symbolTableOpenScope();
+    localStart = symbolTablePtr;
     if (checkLexeme(TLPAREN)) {
         if (currentSymbol != TRPAREN) {
             do {
-                if (currentSymbol == TVAR) {
-                    fatalError("VAR parameters not supported");
-                }
+                isVar = checkLexeme(TVAR);
                 startSymbolTablePtr = symbolTablePtr;
                 do {
                     consumeIdentifier(curParamId);
-                    if (symbolTableFind(curParamId)) fatalError("Duplicate parameter");
-                    symbolTableAdd(curParamId, 0, TSYMPARAM, 0);
+                    if (symbolTableFindInScope(curParamId)) fatalError("Duplicate parameter");
+                    symbolTableAdd(curParamId, 0, isVar ? TSYMVARPARAM : TSYMPARAM, 0);
                 } while (checkLexeme(TCOMMA));
                 matchSymbol(TCOLON, ": expected");
+                openArrayAllowed = 1;
                 tid = parseType(curParamPrefix, curParamSuffix);
+                if (isVar && tid == 9) fatalError("VAR PROCEDURE parameters not supported");
                 for (i = startSymbolTablePtr; i < symbolTablePtr; i++) {
                     symbolTableDataType[i] = tid;
-                    if (strlen(curArgList) > 0) strcat(curArgList, ", ");
-                    printVariable(curOneArg, &symbolTableNameBuffer[symbolTable[i]], curParamPrefix, curParamSuffix);
-                    strcat(curArgList, curOneArg);
+                    if (bufferLen[BUFARGS] > 0) bufferAppend(BUFARGS, ", ");
+                    printParameter(curOneArg, &symbolTableNameBuffer[symbolTable[i]], tid, isVar, curParamPrefix, curParamSuffix);
+                    bufferAppend(BUFARGS, curOneArg);
                 }
             } while (checkLexeme(TSEMICOL));
         }
         matchSymbol(TRPAREN, ") expected");
     }
-    if (strlen(curArgList) == 0) strcpy(curArgList, "void");
+    if (bufferLen[BUFARGS] == 0) bufferAppend(BUFARGS, "void");
     if (checkLexeme(TCOLON)) {
-        parseType(curRetPrefix, curRetSuffix);
+        retType = parseType(curRetPrefix, curRetSuffix);
     }
+    symbolTableDataType[procIndex] = typeTableAdd(10, retType, symbolTablePtr - procIndex - 1);
+    for (i = procIndex + 1; i < symbolTablePtr; i++) typeTableAdd(11, symbolTableDataType[i], symbolTableType[i] == TSYMVARPARAM);
     matchSymbol(TSEMICOL, "; expected");
-    fprintf(fileC, "\n%s%s %s_%s(%s)%s", exp ? "" : "static ", curRetPrefix, moduleName, curProcName, curArgList, curRetSuffix);
-    if (exp) fprintf(fileHeader, "extern %s %s_%s(%s)%s;\n", curRetPrefix, moduleName, curProcName, curArgList, curRetSuffix);
+    curProcIndex = procIndex;
+    curProcExported = exp;
+    procLeaf = 1;
+    if (profMode && !exp) {
+        bufferAppend(BUFC, "\nstatic ");
+        emitProcedureSignature(BUFC, "");
+        bufferAppend(BUFC, ";");
+    }
+    calls = profileCalls();
+    if (calls == 0 || (calls > 0 && calls * PROFHOT >= profileMaxCalls)) {
+        bufferAppend(BUFC, "\n");
+        bufferAppend(BUFC, moduleName);
+        bufferAppend(BUFC, calls == 0 ? "_COLD" : "_HOT");
+    }
+    procSignature = bufferLen[BUFC];
+    bufferAppend(BUFC, exp && !profMode ? "\n" : "\nstatic ");
+    procBody = emitProcedureSignature(BUFC, profMode ? "_body" : "");
+    if (exp) {
+        bufferAppend(BUFH, "extern ");
+        emitProcedureSignature(BUFH, "");
+        bufferAppend(BUFH, ";\n");
+    }
     emitCode(" {\n");
 }
 
+void emitProfileCall(const char *suffix) {
+    int i, n = typeLen[symbolTableDataType[curProcIndex]];
+    bufferAppend(BUFWRAP, moduleName);
+    bufferAppend(BUFWRAP, "_");
+    bufferAppend(BUFWRAP, curProcName);
+    bufferAppend(BUFWRAP, suffix);
+    bufferAppend(BUFWRAP, "(");
+    for (i = 1; i <= n; i++) {
+        if (i > 1) bufferAppend(BUFWRAP, ", ");
+        bufferAppend(BUFWRAP, moduleName);
+        bufferAppend(BUFWRAP, "_");
+        bufferAppend(BUFWRAP, &symbolTableNameBuffer[symbolTable[curProcIndex + i]]);
+        if (isOpenArray(symbolTableDataType[curProcIndex + i])) {
+            bufferAppend(BUFWRAP, ", ");
+            bufferAppend(BUFWRAP, moduleName);
+            bufferAppend(BUFWRAP, "_");
+            bufferAppend(BUFWRAP, &symbolTableNameBuffer[symbolTable[curProcIndex + i]]);
+            bufferAppend(BUFWRAP, "_len");
+        }
+    }
+    bufferAppend(BUFWRAP, ")");
+}
+
+void emitProfileWrapper(void) {
+    char buf[MAXIDLEN * 4 + MAXTYPELEN + 32];
+    int value = strcmp(curRetPrefix, "void") != 0 || curRetSuffix[0];
+    int k = profProcCount - 1;
+    profSig[k] = procSignature;
+    profBody[k] = procBody;
+    profExp[k] = curProcExported;
+    profLeaf[k] = procLeaf && profMode == 1;
+    profWrap[k] = bufferLen[BUFWRAP];
+    sprintf(buf, "Prof_Add(\"%s.%s\", %s_prof_%s);\n", moduleName, curProcName, moduleName, curProcName);
+    bufferAppend(BUFWRAP, buf);
+    profSplit[k] = bufferLen[BUFWRAP];
+    sprintf(buf, "\nstatic uint64_t %s_prof_%s[8] Prof_ALIGN;", moduleName, curProcName);
+    bufferAppend(BUFWRAP, buf);
+    bufferAppend(BUFWRAP, "\nProf_COLD static ");
+    emitProcedureSignature(BUFWRAP, "_timed");
+    bufferAppend(BUFWRAP, " {\n");
+    sprintf(buf, "uint64_t %s_prof_t = Prof_Now();\n", moduleName);
+    bufferAppend(BUFWRAP, buf);
+    if (value) {
+        printVariable(buf, "prof_r", curRetPrefix, curRetSuffix);
+        bufferAppend(BUFWRAP, buf);
+        bufferAppend(BUFWRAP, " = ");
+    }
+    emitProfileCall("_body");
+    bufferAppend(BUFWRAP, ";\n");
+    sprintf(buf, "Prof_Leave(%s_prof_%s, %s_prof_t);\n", moduleName, curProcName, moduleName);
+    bufferAppend(BUFWRAP, buf);
+    if (value) {
+        sprintf(buf, "return %s_prof_r;\n", moduleName);
+        bufferAppend(BUFWRAP, buf);
+    }
+    bufferAppend(BUFWRAP, "}\n");
+    bufferAppend(BUFWRAP, curProcExported ? "\n" : "\nstatic ");
+    emitProcedureSignature(BUFWRAP, "");
+    bufferAppend(BUFWRAP, " {\n");
+    sprintf(buf, "if (Prof_Skip(%s_prof_%s)) ", moduleName, curProcName);
+    bufferAppend(BUFWRAP, buf);
+    if (value) bufferAppend(BUFWRAP, "return ");
+    emitProfileCall("_body");
+    bufferAppend(BUFWRAP, ";\nelse ");
+    if (value) bufferAppend(BUFWRAP, "return ");
+    emitProfileCall("_timed");
+    bufferAppend(BUFWRAP, ";\n}\n");
+}
+
+void emitProfileWrappers(void) {
+    int k;
+    long end;
+    for (k = profProcCount - 1; k >= 0; k--) {
+        if (profHot[k] && !profLeaf[k]) continue;
+        bufferDelete(BUFC, profBody[k], 5);
+        if (profExp[k]) bufferDelete(BUFC, profSig[k] + 1, 7);
+    }
+    for (k = 0; k < profProcCount; k++) {
+        if (!profHot[k] || profLeaf[k]) continue;
+        end = k + 1 < profProcCount ? profWrap[k + 1] : bufferLen[BUFWRAP];
+        bufferAppendRange(BUFPROF, bufferData[BUFWRAP] + profWrap[k], profSplit[k] - profWrap[k]);
+        bufferAppendRange(BUFC, bufferData[BUFWRAP] + profSplit[k], end - profSplit[k]);
+    }
+}
+
 void parseProcedureDeclaration(void) {
-    int oldSymbolTablePtr, oldSymbolTableNameBufferPtr;
-    parseProcedureHeader(&oldSymbolTablePtr, &oldSymbolTableNameBufferPtr);
+    parseProcedureHeader();
     isGlobalDefinition = 0;
     while (checkLexeme(TVAR)) parseVariableDeclaration();
+    irBegin();
     matchSymbol(TBEGIN, "BEGIN expected");
     parseStatementSequence();
     matchSymbol(TEND, "END expected");
     matchSymbol(TIDENT, "Identifier expected");
     matchSymbol(TSEMICOL, "; expected");
+    irFinish();
     emitCode("}\n");
+    if (profMode) emitProfileWrapper();
     isGlobalDefinition = 1;
-    symbolTablePtr = oldSymbolTablePtr;
-    symbolTableNameBufferPtr = oldSymbolTableNameBufferPtr;
+    symbolTableCloseScope();
 }
 
 void parseConstantDeclaration(void) {
-    int isExported;
+    int isExported, i;
     int tid = 0;
     while (currentSymbol == TIDENT) {
         consumeIdentifier(constDeclName);
         isExported = checkLexeme(TMUL);
         matchSymbol(TEQ, "= expected");
-        if (currentSymbol == TNUMBER) {
-            if (strchr(currentToken, '.') || strchr(currentToken, 'E')) tid = 3;
-            else tid = 1;
-        } else if (currentSymbol == TSTRING) {
+        if (currentSymbol == TSTRING) {
             tid = 7;
-        } else if (currentSymbol == TCHAR) {
-            tid = 6;
-        }
-        symbolTableAdd(constDeclName, 0, TSYMCONST, tid);
-        fprintf(isExported ? fileHeader : fileC, "#define\t%s_%s\t%s\n", moduleName, constDeclName, currentToken);
-        if (currentSymbol == TNUMBER) matchSymbol(TNUMBER, "Number expected");
-        else if (currentSymbol == TSTRING) matchSymbol(TSTRING, "String expected");
-        else if (currentSymbol == TCHAR) matchSymbol(TCHAR, "Char expected");
-        else nextToken();
+            strcpy(constValueBuf, currentToken);
+            nextToken();
+        } else {
+            tid = parseConstExpression();
+            formatConstant(constValueBuf, tid);
+        }
+        i = symbolTableAdd(constDeclName, isExported, TSYMCONST, tid);
+        symbolTableIntValue[i] = exprIntVal;
+        symbolTableRealValue[i] = exprRealVal;
+        bufferAppend(isExported ? BUFH : BUFC, "#define\t");
+        bufferAppend(isExported ? BUFH : BUFC, moduleName);
+        bufferAppend(isExported ? BUFH : BUFC, "_");
+        bufferAppend(isExported ? BUFH : BUFC, constDeclName);
+        bufferAppend(isExported ? BUFH : BUFC, "\t");
+        bufferAppend(isExported ? BUFH : BUFC, constValueBuf);
+        bufferAppend(isExported ? BUFH : BUFC, "\n");
+        matchSymbol(TSEMICOL, "; expected");
+    }
+}
+
+void parseTypeDeclaration(void) {
+    int isExported, i, t, fwd, tid;
+    while (currentSymbol == TIDENT) {
+        consumeIdentifier(typeDeclName);
+        isExported = checkLexeme(TMUL);
+        matchSymbol(TEQ, "= expected");
+        if (symbolTableFindInScope(typeDeclName)) fatalError("Duplicate identifier");
+        sprintf(typeDeclCName, "%s_%s", moduleName, typeDeclName);
+        if (checkLexeme(TRECORD)) {
+            fwd = typeTableAdd(0, 0, 0);
+            i = symbolTableAdd(typeDeclName, isExported, TSYMTYPE, fwd);
+            bufferAppend(BUFH, "typedef struct ");
+            bufferAppend(BUFH, typeDeclCName);
+            bufferAppend(BUFH, " ");
+            bufferAppend(BUFH, typeDeclCName);
+            bufferAppend(BUFH, ";\n");
+            tid = parseRecord(typeDeclCName, fwd);
+            for (t = fwd + 1; t < tid; t++) {
+                if (typeForm[t] == 8 && typeBase[t] == fwd) typeBase[t] = tid;
+            }
+            symbolTableDataType[i] = tid;
+        } else {
+            tid = parseType(typeDeclPrefix, typeDeclSuffix);
+            symbolTableAdd(typeDeclName, isExported, TSYMTYPE, tid);
+            bufferAppend(BUFH, "typedef ");
+            bufferAppend(BUFH, typeDeclPrefix);
+            bufferAppend(BUFH, " ");
+            bufferAppend(BUFH, typeDeclCName);
+            bufferAppend(BUFH, typeDeclSuffix);
+            bufferAppend(BUFH, ";\n");
+        }
         matchSymbol(TSEMICOL, "; expected");
     }
 }
@@ -985,10 +3710,40 @@ void parseConstantDeclaration(void) {
 void initCompiler(void) {
     currentLine = 1;
     isGlobalDefinition = 0;
-    captureBuffer = NULL;
-    symbolTablePtr = 0;
-    symbolTableNameBufferPtr = 0;
-    typesPtr = 10;
+    headerDirectives = 0;
+    lineMapped = 0;
+    lineCount = 0;
+    lineCountPos = 0;
+    outputNameC[0] = 0;
+    outputNameHeader[0] = 0;
+    outputNameSym[0] = 0;
+    outputNameCache[0] = 0;
+    emitBuffer = BUFC;
+    bufferReset(BUFC);
+    bufferReset(BUFH);
+    bufferReset(BUFSYM);
+    bufferReset(BUFPROF);
+    bufferReset(BUFWRAP);
+    profProcCount = 0;
+    branchCount = 0;
+    statsTokens = 0;
+    statsLookups = 0;
+    statsProbes = 0;
+    statsSymbols = 0;
+    statsLex = 0;
+    statsEmit = 0;
+    symbolTableReset();
+    typesPtr = 0;
+    fieldNamesLen = 0;
+    fieldCount = 0;
+    recordCount = 0;
+    exitCount = 0;
+    forCount = 0;
+    caseLabelCount = 0;
+    caseCount = 0;
+    vecHelpers = 0;
+    divHelpers = 0;
+    while (typesPtr < 10) typeTableAdd(0, 0, 0);
     typeForm[1]=1;
     typeForm[2]=2;
     typeForm[3]=3;
@@ -996,82 +3751,429 @@ void initCompiler(void) {
     typeForm[5]=5;
     typeForm[6]=6;
     typeForm[8]=8;
-    symbolTableAdd("MODULE", 0, TMODULE, 0);
-    symbolTableAdd("BEGIN", 0, TBEGIN, 0);
-    symbolTableAdd("END", 0, TEND, 0);
-    symbolTableAdd("IMPORT", 0, TIMPORT, 0);
-    symbolTableAdd("CONST", 0, TCONST, 0);
-    symbolTableAdd("VAR", 0, TVAR, 0);
-    symbolTableAdd("PROCEDURE", 0, TPROC, 0);
-    symbolTableAdd("IF", 0, TIF, 0);
-    symbolTableAdd("THEN", 0, TTHEN, 0);
-    symbolTableAdd("ELSIF", 0, TELSIF, 0);
-    symbolTableAdd("ELSE", 0, TELSE, 0);
-    symbolTableAdd("WHILE", 0, TWHILE, 0);
-    symbolTableAdd("DO", 0, TDO, 0);
-    symbolTableAdd("REPEAT", 0, TREPEAT, 0);
-    symbolTableAdd("UNTIL", 0, TUNTIL, 0);
-    symbolTableAdd("RETURN", 0, TRETURN, 0);
-    symbolTableAdd("ARRAY", 0, TARRAY, 0);
-    symbolTableAdd("OF", 0, TOF, 0);
-    symbolTableAdd("POINTER", 0, TPOINTER, 0);
-    symbolTableAdd("TO", 0, TTO, 0);
-    symbolTableAdd("INC", 0, TINC, 0);
-    symbolTableAdd("DEC", 0, TDEC, 0);
-    symbolTableAdd("BREAK", 0, TBREAK, 0);
-    symbolTableAdd("CONTINUE", 0, TCONT, 0);
-    symbolTableAdd("OR", 0, TOR, 0);
-    symbolTableAdd("DIV", 0, TDIV, 0);
-    symbolTableAdd("MOD", 0, TMOD, 0);
-    symbolTableAdd("TRUE", 0, TTRUE, 5);
-    symbolTableAdd("FALSE", 0, TFALSE, 5);
-    symbolTableAdd("NIL", 0, TNIL, 8);
-    symbolTableAdd("ABS", 0, TFABS, 0);
-    symbolTableAdd("ODD", 0, TFODD, 0);
-    symbolTableAdd("ASH", 0, TFASH, 0);
-    symbolTableAdd("ASSERT", 0, TFASSERT, 0);
-    symbolTableAdd("ORD", 0, TFORD, 0);
-    symbolTableAdd("CHR", 0, TFCHR, 0);
-    symbolTableAdd("FLOOR", 0, TFFLOOR, 0);
-    symbolTableAdd("INTEGER", 0, TTYPEINT, 1);
-    symbolTableAdd("LONGINT", 0, TTYPELONG, 2);
-    symbolTableAdd("REAL", 0, TTYPEREAL, 3);
-    symbolTableAdd("LONGREAL", 0, TTYPEDBL, 4);
-    symbolTableAdd("BOOLEAN", 0, TTYPEBOOL, 5);
-    symbolTableAdd("CHAR", 0, TTYPECHAR, 6);
-    fileIn = fileHeader = fileC = NULL;
 }
 
-void compileModule(char *src) {
-    char *dot;
-    int len;
-    int moduleId, moduleAliasId;
-    initCompiler();
-    strcpy(sourceFileName, src);
-    fileIn = fopen(sourceFileName, "r");
-    if (!fileIn) {
-        printf("Error: Cannot open %s\n", sourceFileName);
-        exit(1);
+void loadSource(void) {
+    FILE *f;
+    long size;
+    f = fopen(sourceFileName, "rb");
+    if (!f) {
+        diagnostic("Error: Cannot open %s\n", sourceFileName);
+        stopTranslation();
     }
-    dot = strrchr(sourceFileName, '.');
-    len = dot ? (int)(dot - sourceFileName) : (int)strlen(sourceFileName);
-    strncpy(outputNameC, sourceFileName, len);
-    outputNameC[len] = '\0';
-    strcpy(outputNameHeader, outputNameC);
-    strcat(outputNameC, ".c");
-    strcat(outputNameHeader, ".h");
-    fileC = fopen(outputNameC, "rw");
-    fileHeader = fopen(outputNameHeader, "rw");
-    if (!fileC || !fileHeader) fatalError("Cannot create output files");
-    currentChar = fgetc(fileIn);
-    nextToken();
-    matchSymbol(TMODULE, "MODULE expected");
-    consumeIdentifier(moduleName);
-    symbolTableAdd(moduleName, 0, TSYMTHISMOD, 0);
-    matchSymbol(TSEMICOL, "; expected");
-    fprintf(fileHeader, "#ifndef %s_H\n#define %s_H\n\n#include <stdint.h>\n#include <stdbool.h>\n#include <stdlib.h>\n#include <string.h>\n#include <math.h>\n", moduleName, moduleName);
-    fprintf(fileHeader, "#define %s_ASH(x, n) ((n) >= 0 ? ((x) << (n)) : ((x) >> -(n)))\n\n", moduleName);
-    isGlobalDefinition = 1;
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    sourceBuffer = (char *)malloc(size + 2);
+    if (!sourceBuffer) {
+        fclose(f);
+        diagnostic("Error: Cannot load %s\n", sourceFileName);
+        stopTranslation();
+    }
+    size = (long)fread(sourceBuffer, 1, size, f);
+    fclose(f);
+    sourceBuffer[size] = 0;
+    sourceBuffer[size + 1] = 0;
+    sourcePtr = sourceBuffer;
+    sourceEnd = sourceBuffer + size;
+}
+
+int symMarkType(int t) {
+    int i, n;
+    if (t < 10) return t;
+    if (symTypeMap[t] == 0) {
+        n = typeForm[t] == 10 || typeForm[t] == 12 ? typeLen[t] + 1 : 1;
+        for (i = 0; i < n; i++) {
+            symTypeMap[t + i] = 10 + symTypeCount;
+            symTypeOrder[symTypeCount++] = t + i;
+        }
+        for (i = 0; i < n; i++) symMarkType(typeBase[t + i]);
+    }
+    return symTypeMap[t];
+}
+
+int isExportedSymbol(int i) {
+    if (symbolTableType[i] == TSYMGEVAR) return 1;
+    if (symbolTableType[i] == TSYMPROC || symbolTableType[i] == TSYMCONST || symbolTableType[i] == TSYMTYPE) return symbolTableId[i];
+    return 0;
+}
+
+void writeSymbolFile(void) {
+    int i, count = 0;
+    char *name;
+    symTypeMap = (int *)growArray(symTypeMap, typesPtr, sizeof(int));
+    symTypeOrder = (int *)growArray(symTypeOrder, typesPtr, sizeof(int));
+    for (i = 0; i < typesPtr; i++) symTypeMap[i] = 0;
+    symTypeCount = 0;
+    for (i = 0; i < symbolTablePtr; i++) {
+        if (isExportedSymbol(i)) {
+            symMarkType(symbolTableDataType[i]);
+            count++;
+        }
+    }
+    bufferAppendRange(BUFSYM, SYMMAGIC, 8);
+    bufferAppendInt(BUFSYM, headerDirectives ? 2 : 1);
+    bufferAppendInt(BUFSYM, symTypeCount);
+    for (i = 0; i < symTypeCount; i++) {
+        bufferAppendInt(BUFSYM, typeForm[symTypeOrder[i]]);
+        bufferAppendInt(BUFSYM, symMarkType(typeBase[symTypeOrder[i]]));
+        if (typeForm[symTypeOrder[i]] == 13 || typeForm[symTypeOrder[i]] == 14) {
+            name = &fieldNames[typeLen[symTypeOrder[i]]];
+            bufferAppendInt(BUFSYM, (long)strlen(name));
+            bufferAppendRange(BUFSYM, name, (long)strlen(name));
+        } else {
+            bufferAppendInt(BUFSYM, typeLen[symTypeOrder[i]]);
+        }
+    }
+    bufferAppendInt(BUFSYM, count);
+    for (i = 0; i < symbolTablePtr; i++) {
+        if (isExportedSymbol(i)) {
+            name = &symbolTableNameBuffer[symbolTable[i]];
+            bufferAppendInt(BUFSYM, symbolTableType[i]);
+            bufferAppendInt(BUFSYM, symMarkType(symbolTableDataType[i]));
+            bufferAppendInt(BUFSYM, (long)strlen(name));
+            bufferAppendRange(BUFSYM, name, (long)strlen(name));
+            if (symbolTableType[i] == TSYMCONST) {
+                constValueBuf[0] = 0;
+                exprIntVal = symbolTableIntValue[i];
+                exprRealVal = symbolTableRealValue[i];
+                if (symbolTableDataType[i] != 7) formatConstant(constValueBuf, symbolTableDataType[i]);
+                bufferAppendInt(BUFSYM, (long)strlen(constValueBuf));
+                bufferAppendRange(BUFSYM, constValueBuf, (long)strlen(constValueBuf));
+            }
+        }
+    }
+}
+
+long symReadInt(void) {
+    unsigned char *p = (unsigned char *)symPtr;
+    if (symEnd - symPtr < 4) fatalError("Corrupt symbol file");
+    symPtr += 4;
+    return (long)p[0] | ((long)p[1] << 8) | ((long)p[2] << 16) | ((long)p[3] << 24);
+}
+
+int symReadType(int localBase, long count) {
+    long t = symReadInt();
+    if (t >= 10 + count) fatalError("Corrupt symbol file");
+    return t < 10 ? (int)t : localBase + (int)(t - 10);
+}
+
+#ifdef HAVEFORK
+int symCacheFind(const char *path, double *stamp, long *size) {
+    struct stat st;
+    char key[MAXFNAMELEN * 2];
+    unsigned long h;
+    int i;
+    if (stat(path, &st) != 0) return -1;
+    *stamp = (double)st.st_mtime;
+#ifdef __linux__
+    *stamp += st.st_mtim.tv_nsec / 1e9;
+#endif
+    *size = (long)st.st_size;
+    strcpy(key, path[0] == '/' ? "" : serverDir);
+    strcat(key, path);
+    h = hashBytes(2166136261UL, key, (long)strlen(key));
+    for (i = 0; i < symCacheCount; i++) {
+        if (symCacheHash[i] == h && strcmp(symCacheName[i], key) == 0) return i;
+    }
+    if (symCacheCount >= symCacheCapacity) {
+        symCacheCapacity = symCacheCapacity ? symCacheCapacity * 2 : 64;
+        symCacheName = (char **)growArray(symCacheName, symCacheCapacity, sizeof(char *));
+        symCacheData = (char **)growArray(symCacheData, symCacheCapacity, sizeof(char *));
+        symCacheHash = (unsigned long *)growArray(symCacheHash, symCacheCapacity, sizeof(unsigned long));
+        symCacheSize = (long *)growArray(symCacheSize, symCacheCapacity, sizeof(long));
+        symCacheTime = (double *)growArray(symCacheTime, symCacheCapacity, sizeof(double));
+        symCacheTable = (long **)growArray(symCacheTable, symCacheCapacity, sizeof(long *));
+        symCacheText = (char **)growArray(symCacheText, symCacheCapacity, sizeof(char *));
+        symCacheReal = (double **)growArray(symCacheReal, symCacheCapacity, sizeof(double *));
+    }
+    symCacheName[symCacheCount] = copyString(key, (int)strlen(key));
+    symCacheData[symCacheCount] = NULL;
+    symCacheHash[symCacheCount] = h;
+    symCacheSize[symCacheCount] = -1;
+    symCacheTime[symCacheCount] = 0;
+    symCacheTable[symCacheCount] = NULL;
+    symCacheText[symCacheCount] = NULL;
+    symCacheReal[symCacheCount] = NULL;
+    return symCacheCount++;
+}
+
+void symCacheStore(int c, int moduleId, int localBase, int symBase) {
+    long *d;
+    char *text;
+    long n = 3 + (typesPtr - localBase) * 3L + (symbolTablePtr - symBase) * 4L, p = 3, used = 0, size = 0, len;
+    int i, t;
+    for (i = localBase; i < typesPtr; i++) {
+        if (typeForm[i] == 13 || typeForm[i] == 14) size += (long)strlen(&fieldNames[typeLen[i]]) + 1;
+    }
+    for (i = symBase; i < symbolTablePtr; i++) size += (long)strlen(&symbolTableNameBuffer[symbolTable[i]]) + 1;
+    d = (long *)growArray(NULL, (int)n, sizeof(long));
+    text = (char *)growArray(NULL, (int)size + 1, 1);
+    symCacheReal[c] = (double *)growArray(NULL, symbolTablePtr - symBase + 1, sizeof(double));
+    d[0] = symbolTableDataType[moduleId];
+    d[1] = typesPtr - localBase;
+    d[2] = symbolTablePtr - symBase;
+    for (i = localBase; i < typesPtr; i++) {
+        t = typeBase[i];
+        d[p++] = typeForm[i];
+        d[p++] = t >= localBase ? t - localBase + 10 : t;
+        if (typeForm[i] == 13 || typeForm[i] == 14) {
+            len = (long)strlen(&fieldNames[typeLen[i]]) + 1;
+            memcpy(text + used, &fieldNames[typeLen[i]], len);
+            d[p++] = used;
+            used += len;
+        } else {
+            d[p++] = typeLen[i];
+        }
+    }
+    for (i = symBase; i < symbolTablePtr; i++) {
+        t = symbolTableDataType[i];
+        len = (long)strlen(&symbolTableNameBuffer[symbolTable[i]]) + 1;
+        memcpy(text + used, &symbolTableNameBuffer[symbolTable[i]], len);
+        d[p++] = symbolTableType[i];
+        d[p++] = t >= localBase ? t - localBase + 10 : t;
+        d[p++] = used;
+        d[p++] = symbolTableIntValue[i];
+        symCacheReal[c][i - symBase] = symbolTableRealValue[i];
+        used += len;
+    }
+    symCacheTable[c] = d;
+    symCacheText[c] = text;
+}
+
+void symCacheLoad(int c, int moduleId) {
+    long *d = symCacheTable[c];
+    char *text = symCacheText[c];
+    long i, p = 3;
+    int localBase = typesPtr, idx, t;
+    symbolTableDataType[moduleId] = (int)d[0];
+    for (i = 0; i < d[1]; i++, p += 3) {
+        t = d[p + 1] < 10 ? (int)d[p + 1] : localBase + (int)(d[p + 1] - 10);
+        if (d[p] == 13 || d[p] == 14) {
+            typeTableAdd((int)d[p], t, fieldNameAdd(text + d[p + 2], (int)strlen(text + d[p + 2])));
+        } else {
+            typeTableAdd((int)d[p], t, (int)d[p + 2]);
+        }
+    }
+    for (i = 0; i < d[2]; i++, p += 4) {
+        t = d[p + 1] < 10 ? (int)d[p + 1] : localBase + (int)(d[p + 1] - 10);
+        idx = symbolTableAdd(text + d[p + 2], 1, (int)d[p], t);
+        symbolTableIntValue[idx] = d[p + 3];
+        symbolTableRealValue[idx] = symCacheReal[c][i];
+    }
+}
+#endif
+
+long readSymbolFile(const char *modName) {
+    FILE *f;
+    long size, len;
+    char *dir;
+#ifdef HAVEFORK
+    double stamp;
+    int c = -1;
+#endif
+#ifdef SOBTLIB
+    int i;
+    for (i = libSymCount - 1; i >= 0; i--) {
+        if (strcmp(libSymName[i], modName) == 0) {
+            symData = (char *)malloc(libSymSize[i] + 1);
+            if (!symData) fatalError("Out of memory");
+            memcpy(symData, libSymData[i], libSymSize[i]);
+            return libSymSize[i];
+        }
+    }
+#endif
+    dir = strrchr(sourceFileName, '/');
+    if (dir == NULL) dir = strrchr(sourceFileName, '\\');
+    len = dir ? (long)(dir - sourceFileName + 1) : 0;
+    if (len + strlen(modName) + 5 > MAXFNAMELEN) return -1;
+    strncpy(desQualName, sourceFileName, len);
+    desQualName[len] = 0;
+    strcat(desQualName, modName);
+    strcat(desQualName, ".sym");
+#ifdef HAVEFORK
+    symCacheSlot = -1;
+    if (serverMode) {
+        c = symCacheFind(desQualName, &stamp, &size);
+        if (c < 0) return -1;
+        if (symCacheSize[c] == size && symCacheTime[c] == stamp) {
+            symData = (char *)malloc(size + 1);
+            if (!symData) fatalError("Out of memory");
+            memcpy(symData, symCacheData[c], size);
+            symCacheSlot = c;
+            return size;
+        }
+    }
+#endif
+    f = fopen(desQualName, "rb");
+    if (!f) return -1;
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    symData = (char *)malloc(size + 1);
+    if (!symData) {
+        fclose(f);
+        fatalError("Out of memory");
+    }
+    size = (long)fread(symData, 1, size, f);
+    fclose(f);
+#ifdef HAVEFORK
+    if (c >= 0) {
+        symCacheData[c] = (char *)growArray(symCacheData[c], size + 1, 1);
+        memcpy(symCacheData[c], symData, size);
+        symCacheSize[c] = size;
+        symCacheTime[c] = stamp;
+        free(symCacheTable[c]);
+        free(symCacheText[c]);
+        free(symCacheReal[c]);
+        symCacheTable[c] = NULL;
+        symCacheText[c] = NULL;
+        symCacheReal[c] = NULL;
+        symCacheSlot = c;
+    }
+#endif
+    return size;
+}
+
+void loadSymbolFile(int moduleId) {
+    long size, n, i, kind, len, count, slots = 0, slotForm = 0;
+    int localBase, dtype, idx;
+    char *modName = &symbolTableNameBuffer[symbolTable[moduleId]];
+#ifdef HAVEFORK
+    int symBase = symbolTablePtr;
+#endif
+    size = readSymbolFile(modName);
+    if (size < 0) return;
+#ifdef HAVEFORK
+    if (symCacheSlot >= 0 && symCacheTable[symCacheSlot]) {
+        free(symData);
+        symData = NULL;
+        symCacheLoad(symCacheSlot, moduleId);
+        return;
+    }
+#endif
+    symPtr = symData;
+    symEnd = symData + size;
+    if (size < 8 || memcmp(symData, SYMMAGIC, 8) != 0) fatalError("Corrupt symbol file");
+    symPtr += 8;
+    symbolTableDataType[moduleId] = (int)symReadInt();
+    if (symbolTableDataType[moduleId] != 1 && symbolTableDataType[moduleId] != 2) fatalError("Corrupt symbol file");
+    count = symReadInt();
+    if (count > (symEnd - symPtr) / 12) fatalError("Corrupt symbol file");
+    localBase = typesPtr;
+    for (i = 0; i < count; i++) {
+        kind = symReadInt();
+        dtype = symReadType(localBase, count);
+        len = symReadInt();
+        if (slots > 0) {
+            if (kind != slotForm && !(slotForm == 13 && kind == 14)) fatalError("Corrupt symbol file");
+            slots--;
+        } else if (kind == 10 || kind == 12) {
+            if (len > count - i - 1 || (kind == 12 && len == 0)) fatalError("Corrupt symbol file");
+            slots = len;
+            slotForm = kind + 1;
+        } else if (kind != 7 && kind != 8) {
+            fatalError("Corrupt symbol file");
+        }
+        if (kind == 13 || kind == 14) {
+            if (len >= MAXIDLEN || symEnd - symPtr < len) fatalError("Corrupt symbol file");
+            typeTableAdd((int)kind, dtype, fieldNameAdd(symPtr, (int)len));
+            symPtr += len;
+        } else {
+            typeTableAdd((int)kind, kind == 12 ? 1 : dtype, (int)len);
+        }
+    }
+    if (slots > 0) fatalError("Corrupt symbol file");
+    n = symReadInt();
+    if (n > (symEnd - symPtr) / 12) fatalError("Corrupt symbol file");
+    for (i = 0; i < n; i++) {
+        kind = symReadInt();
+        if (kind != TSYMCONST && kind != TSYMPROC && kind != TSYMGEVAR && kind != TSYMTYPE) fatalError("Corrupt symbol file");
+        dtype = symReadType(localBase, count);
+        if (kind == TSYMPROC && typeForm[dtype] != 10) fatalError("Corrupt symbol file");
+        len = symReadInt();
+        if (len >= MAXIDLEN || symEnd - symPtr < len) fatalError("Corrupt symbol file");
+        sprintf(desQualName, "%s.", modName);
+        strncat(desQualName, symPtr, len);
+        symPtr += len;
+        idx = symbolTableAdd(desQualName, 1, (int)kind, dtype);
+        if (kind == TSYMCONST) {
+            len = symReadInt();
+            if (len >= (long)sizeof(constValueBuf) || symEnd - symPtr < len) fatalError("Corrupt symbol file");
+            memcpy(constValueBuf, symPtr, len);
+            constValueBuf[len] = 0;
+            symPtr += len;
+            if (len > 0) {
+                setConstantValue(constValueBuf, dtype);
+                symbolTableIntValue[idx] = exprIntVal;
+                symbolTableRealValue[idx] = exprRealVal;
+            }
+        }
+        modName = &symbolTableNameBuffer[symbolTable[moduleId]];
+    }
+    if (symPtr != symEnd) fatalError("Corrupt symbol file");
+    free(symData);
+    symData = NULL;
+#ifdef HAVEFORK
+    if (symCacheSlot >= 0) symCacheStore(symCacheSlot, moduleId, localBase, symBase);
+#endif
+}
+
+unsigned long hashBytes(unsigned long h, const char *s, long len) {
+    while (len-- > 0) {
+        h ^= (unsigned char)*s++;
+        h = (h * 16777619UL) & 0xFFFFFFFFUL;
+    }
+    return h;
+}
+
+unsigned long hashImport(unsigned long h, const char *name) {
+    long size = readSymbolFile(name);
+    h = hashBytes(h, name, (long)strlen(name) + 1);
+    if (size < 0) return h;
+    h = hashBytes(h, symData, size);
+    free(symData);
+    symData = NULL;
+    return h;
+}
+
+int isTranslationCurrent(void) {
+    FILE *f;
+    unsigned long h, imports = sourceHash;
+    char name[MAXIDLEN];
+    int ok;
+    f = fopen(outputNameCache, "r");
+    if (!f) return 0;
+    ok = fscanf(f, "sobt %lx", &h) == 1;
+    while (ok && fscanf(f, "%31s", name) == 1) imports = hashImport(imports, name);
+    fclose(f);
+    if (!ok || h != imports) return 0;
+    f = fopen(outputNameC, "r");
+    if (!f) return 0;
+    fclose(f);
+    f = fopen(outputNameHeader, "r");
+    if (!f) return 0;
+    fclose(f);
+    f = fopen(outputNameSym, "rb");
+    if (!f) return 0;
+    fclose(f);
+    return 1;
+}
+
+void writeTranslationCache(void) {
+    FILE *f = fopen(outputNameCache, "w");
+    unsigned long h = sourceHash;
+    int i;
+    if (!f) return;
+    for (i = 0; i < importCount; i++) h = hashImport(h, &symbolTableNameBuffer[symbolTable[importIds[i]]]);
+    fprintf(f, "sobt %08lx\n", h);
+    for (i = 0; i < importCount; i++) fprintf(f, "%s\n", &symbolTableNameBuffer[symbolTable[importIds[i]]]);
+    fclose(f);
+}
+
+void parseImportList(void) {
+    int moduleId, moduleAliasId;
+    importCount = 0;
     while (checkLexeme(TIMPORT)) {
         do {
             if (currentSymbol == TIDENT) {
@@ -1084,15 +4186,130 @@ void compileModule(char *src) {
                     symbolTableId[moduleAliasId] = moduleId;
                     matchSymbol(TIDENT, "module name expected");
                 }
-                fprintf(fileC, "#include \"%s.h\"\n", symbolTableNameBuffer[symbolTable[moduleId]]);
+                if (importCount >= importCapacity) {
+                    importCapacity = importCapacity ? importCapacity * 2 : 16;
+                    importIds = (int *)growArray(importIds, importCapacity, sizeof(int));
+                }
+                importIds[importCount++] = moduleId;
             }
         } while (checkLexeme(TCOMMA));
         matchSymbol(TSEMICOL, "; expected");
     }
-    fprintf(fileC, "#include \"%s\"\n\n", outputNameHeader);
+}
+
+void emitProfileMacros(void) {
+    static const char *names[4] = { "_HOT", "_COLD", "_LIKELY(x)", "_UNLIKELY(x)" };
+    static const char *gnu[4] = { "__attribute__((hot))", "__attribute__((cold))",
+        "__builtin_expect(!!(x), 1)", "__builtin_expect(!!(x), 0)" };
+    static const char *plain[4] = { "", "", "(x)", "(x)" };
+    int i;
+    bufferAppend(BUFC, "#ifdef __GNUC__\n");
+    for (i = 0; i < 8; i++) {
+        if (i == 4) bufferAppend(BUFC, "#else\n");
+        bufferAppend(BUFC, "#define ");
+        bufferAppend(BUFC, moduleName);
+        bufferAppend(BUFC, names[i % 4]);
+        if (i < 4 || i > 5) bufferAppend(BUFC, " ");
+        bufferAppend(BUFC, i < 4 ? gnu[i] : plain[i % 4]);
+        bufferAppend(BUFC, "\n");
+    }
+    bufferAppend(BUFC, "#endif\n\n");
+}
+
+void emitProfileInit(void) {
+    char buf[MAXIDLEN * 4 + 64];
+    int i;
+    if (profMode == 3) {
+        sprintf(buf, "\nuint64_t %s_prof_br[%d];\nstatic const int %s_prof_line[%d] = {", moduleName,
+            branchCount > 0 ? branchCount * 2 : 2, moduleName, branchCount > 0 ? branchCount : 1);
+        bufferAppend(BUFC, buf);
+        for (i = 0; i < branchCount; i++) {
+            sprintf(buf, i % 16 == 0 ? "\n%d," : " %d,", branchLine[i]);
+            bufferAppend(BUFC, buf);
+        }
+        bufferAppend(BUFC, branchCount > 0 ? "\n};\n" : " 0 };\n");
+        sprintf(buf, "Prof_Module(\"%s\", \"%08lx\", %s_prof_br, %s_prof_line, %d);\n",
+            moduleName, moduleHash, moduleName, moduleName, branchCount);
+        bufferAppend(BUFPROF, buf);
+    }
+    bufferAppend(BUFC, "\nstatic char is_");
+    bufferAppend(BUFC, moduleName);
+    bufferAppend(BUFC, "_prof = 0;\nProf_INIT static void ");
+    bufferAppend(BUFC, moduleName);
+    bufferAppend(BUFC, "_prof_init(void) {\nif(is_");
+    bufferAppend(BUFC, moduleName);
+    bufferAppend(BUFC, "_prof) {\nreturn;\n}\nis_");
+    bufferAppend(BUFC, moduleName);
+    bufferAppend(BUFC, "_prof = 1;\n");
+    bufferAppend(BUFC, bufferData[BUFPROF]);
+    bufferAppend(BUFC, "}\n");
+}
+
+void setOutputNames(void) {
+    char *dot;
+    int len;
+    dot = strrchr(sourceFileName, '.');
+    len = dot ? (int)(dot - sourceFileName) : (int)strlen(sourceFileName);
+    strncpy(outputNameC, sourceFileName, len);
+    outputNameC[len] = '\0';
+    strcpy(outputNameHeader, outputNameC);
+    strcpy(outputNameCache, outputNameC);
+    strcpy(outputNameSym, outputNameC);
+    strcat(outputNameC, ".c");
+    strcat(outputNameHeader, ".h");
+    strcat(outputNameCache, ".sbc");
+    strcat(outputNameSym, ".sym");
+}
+
+void translateModule(void) {
+    int i;
+    moduleHash = hashBytes(2166136261UL, sourceBuffer, (long)(sourceEnd - sourceBuffer));
+    nextToken();
+    matchSymbol(TMODULE, "MODULE expected");
+    consumeIdentifier(moduleName);
+    symbolTableAdd(moduleName, 0, TSYMTHISMOD, 0);
+    loadModuleProfile();
+    bufferAppend(BUFH, "#ifndef ");
+    bufferAppend(BUFH, moduleName);
+    bufferAppend(BUFH, "_H\n#define ");
+    bufferAppend(BUFH, moduleName);
+    bufferAppend(BUFH, "_H\n\n#include <stdint.h>\n#include <stdbool.h>\n#include <stdlib.h>\n#include <string.h>\n#include <math.h>\n");
+    bufferAppend(BUFH, "#define ");
+    bufferAppend(BUFH, moduleName);
+    bufferAppend(BUFH, "_ASH(x, n) ((n) >= 0 ? ((x) << (n)) : ((x) >> -(n)))\n");
+    if (boundsMode) {
+        bufferAppend(BUFH, "#include <stdio.h>\nstatic inline long ");
+        bufferAppend(BUFH, moduleName);
+        bufferAppend(BUFH, "_IDX(long i, long n, int line) {\n    if ((unsigned long)i >= (unsigned long)n) {\n        fprintf(stderr, \"");
+        bufferAppend(BUFH, moduleName);
+        bufferAppend(BUFH, ":%d: index %ld out of range 0..%ld\\n\", line, i, n - 1);\n        abort();\n    }\n    return i;\n}\n");
+    }
+    bufferAppend(BUFH, "\n");
+    matchSymbol(TSEMICOL, "; expected");
+    isGlobalDefinition = 1;
+    parseImportList();
+    for (i = 0; i < importCount; i++) {
+        loadSymbolFile(importIds[i]);
+        bufferAppend(BUFC, "#include \"");
+        bufferAppend(BUFC, &symbolTableNameBuffer[symbolTable[importIds[i]]]);
+        bufferAppend(BUFC, ".h\"\n");
+    }
+    if (profMode) bufferAppend(BUFC, "#include \"Prof.h\"\n");
+    bufferAppend(BUFC, "#include \"");
+    bufferAppend(BUFC, outputNameHeader);
+    bufferAppend(BUFC, "\"\n\n");
+    helperPos = bufferLen[BUFC];
+    if (profileMatched) emitProfileMacros();
+    if (profMode == 3) {
+        bufferAppend(BUFC, "extern uint64_t ");
+        bufferAppend(BUFC, moduleName);
+        bufferAppend(BUFC, "_prof_br[];\n");
+    }
     while (1) {
         if (checkLexeme(TCONST)) {
             parseConstantDeclaration();
+        } else if (checkLexeme(TTYPE)) {
+            parseTypeDeclaration();
         } else if (checkLexeme(TVAR)) {
             parseVariableDeclaration();
         } else if(checkLexeme(TPROC)) {
@@ -1101,34 +4318,951 @@ void compileModule(char *src) {
             break;
         }
     }
-    fprintf(fileC, "\nstatic char is_%s_init = 0;\n", moduleName);
-    fprintf(fileC, "void mod_%s_init() {\n", moduleName);
-    fprintf(fileC, "if(is_%s_init) {\nreturn;\n}\nis_%s_init = 1;\n", moduleName, moduleName);
+    if (profMode) emitProfileWrappers();
+    if (bufferLen[BUFPROF] > 0 || profMode == 3) {
+        bufferAppend(BUFC, "\nProf_INIT static void ");
+        bufferAppend(BUFC, moduleName);
+        bufferAppend(BUFC, "_prof_init(void);\n");
+    }
+    bufferAppend(BUFC, "\nstatic char is_");
+    bufferAppend(BUFC, moduleName);
+    bufferAppend(BUFC, "_init = 0;\nvoid mod_");
+    bufferAppend(BUFC, moduleName);
+    bufferAppend(BUFC, "_init() {\nif(is_");
+    bufferAppend(BUFC, moduleName);
+    bufferAppend(BUFC, "_init) {\nreturn;\n}\nis_");
+    bufferAppend(BUFC, moduleName);
+    bufferAppend(BUFC, "_init = 1;\n");
+    if (bufferLen[BUFPROF] > 0 || profMode == 3) {
+        bufferAppend(BUFC, moduleName);
+        bufferAppend(BUFC, "_prof_init();\n");
+    }
+    localStart = symbolTablePtr;
+    irBegin();
     if(checkLexeme(TBEGIN)) {
         parseStatementSequence();
     }
+    irFinish();
     emitCode("}\n");
-    fprintf(fileHeader, "\nextern void mod_%s_init();\n", moduleName);
+    if (bufferLen[BUFPROF] > 0 || profMode == 3) emitProfileInit();
+    bufferAppend(BUFH, "\nextern void mod_");
+    bufferAppend(BUFH, moduleName);
+    bufferAppend(BUFH, "_init();\n");
     matchSymbol(TEND, "END expected");
     matchSymbol(TIDENT, "Identifier expected");
     matchSymbol(TDOT, ". expected");
     matchSymbol(TEOF, "EOF expected");
-    fprintf(fileHeader, "\n#endif\n", moduleName);
+    emitHelpers();
+    bufferAppend(BUFH, "\n#endif\n");
+}
+
+void compileModule(char *src) {
+    double t;
+    symChanged = 0;
+    initCompiler();
+    statsStart = statsMode ? statsNow() : 0;
+    strcpy(sourceFileName, src);
+    loadSource();
+    setOutputNames();
+    if (incrementalMode) {
+        sourceHash = hashBytes(2166136261UL, translateOptions, (long)strlen(translateOptions));
+        sourceHash = hashBytes(sourceHash, sourceBuffer, (long)(sourceEnd - sourceBuffer));
+        if (profileData) sourceHash = hashBytes(sourceHash, profileData, (long)strlen(profileData));
+        if (isTranslationCurrent()) {
+            statsAlloc = statsAllocated();
+            cleanupFiles();
+            if (statsMode) statsModule(0);
+            return;
+        }
+    }
+    translateModule();
+    t = statsMode ? statsNow() : 0;
+    writeSymbolFile();
+    statsAlloc = statsAllocated();
     cleanupFiles();
+    bufferFlush(BUFC, outputNameC, 0);
+    bufferFlush(BUFH, outputNameHeader, 0);
+    symChanged = bufferFlush(BUFSYM, outputNameSym, 1);
+    if (incrementalMode) writeTranslationCache();
+    if (statsMode) {
+        statsEmit += statsNow() - t;
+        statsModule(1);
+    }
 }
 
-int main(int argc, char **argv) {
+void resetOptions(void) {
+    incrementalMode = 0;
+    optimizeMode = 0;
+    boundsMode = 0;
+    linesMode = 0;
+    profMode = 0;
+    layoutMode = 0;
+    gotoMode = 0;
+    statsMode = 0;
+    translateOptions[0] = 0;
+    if (profileData) free(profileData);
+    profileData = NULL;
+}
+
+void setOption(const char *opt) {
+    if (strcmp(opt, "-O") == 0) optimizeMode = 1;
+    if (strcmp(opt, "-bounds") == 0) boundsMode = 1;
+    if (strcmp(opt, "-bounds-all") == 0) boundsMode = 2;
+    if (strcmp(opt, "-lines") == 0) linesMode = 1;
+    if (strcmp(opt, "-prof") == 0) profMode = 1;
+    if (strcmp(opt, "-prof-all") == 0) profMode = 2;
+    if (strcmp(opt, "-prof-gen") == 0) profMode = 3;
+    if (strcmp(opt, "-layout") == 0) layoutMode = 1;
+    if (strcmp(opt, "-goto") == 0) gotoMode = 1;
+    if (strncmp(opt, "-prof-use=", 10) == 0) loadProfile(opt + 10);
+    if (strlen(translateOptions) + strlen(opt) + 1 < MAXFNAMELEN) {
+        strcat(translateOptions, opt);
+        strcat(translateOptions, " ");
+    }
+}
+
+#ifdef SOBTLIB
+
+const int libOutputBuffer[4] = { BUFC, BUFH, BUFSYM, BUFDIAG };
+
+int sobtTranslate(const char *fileName, const char *source, long size, const char *options) {
+    char opt[MAXFNAMELEN];
+    const char *p;
+    int len;
+    if (setjmp(translationAbort)) {
+        for (len = SOBTC; len < SOBTDIAG; len++) {
+            if (bufferSize[libOutputBuffer[len]] > 0) {
+                bufferLen[libOutputBuffer[len]] = 0;
+                bufferData[libOutputBuffer[len]][0] = 0;
+            }
+        }
+        return 1;
+    }
+    diagToBuffer = 1;
+    errorJump = 1;
+    bufferReset(BUFDIAG);
+    strncpy(sourceFileName, fileName, MAXFNAMELEN - 1);
+    sourceFileName[MAXFNAMELEN - 1] = 0;
+    currentLine = 0;
+    resetOptions();
+    for (p = options; p && *p; p += len) {
+        while (*p == ' ') p++;
+        len = (int)strcspn(p, " ");
+        if (len == 0) break;
+        if (len >= MAXFNAMELEN) fatalError("Option too long");
+        memcpy(opt, p, len);
+        opt[len] = 0;
+        if (strcmp(opt, "-stats") == 0) statsMode = 1;
+        else setOption(opt);
+    }
+    if (statsMode && statsTimer == 0) statsCalibrate();
+    initCompiler();
+    statsStart = statsMode ? statsNow() : 0;
+    sourceBuffer = (char *)malloc(size + 2);
+    if (!sourceBuffer) fatalError("Out of memory");
+    memcpy(sourceBuffer, source, size);
+    sourceBuffer[size] = 0;
+    sourceBuffer[size + 1] = 0;
+    sourcePtr = sourceBuffer;
+    sourceEnd = sourceBuffer + size;
+    setOutputNames();
+    translateModule();
+    writeSymbolFile();
+    statsAlloc = statsAllocated();
+    cleanupFiles();
+    if (statsMode) statsModule(1);
+    return 0;
+}
+
+const char *sobtOutput(int kind, long *size) {
+    int b;
+    if (size) *size = 0;
+    if (kind < SOBTC || kind > SOBTDIAG) return NULL;
+    b = libOutputBuffer[kind];
+    if (bufferSize[b] == 0) return "";
+    if (size) *size = bufferLen[b];
+    return bufferData[b];
+}
+
+int sobtAddSymbols(const char *module, const char *data, long size) {
+    char **names, **datas;
+    long *sizes;
+    char *name, *copy;
+    if (libSymCount >= libSymCapacity) {
+        libSymCapacity = libSymCapacity ? libSymCapacity * 2 : 16;
+        names = (char **)realloc(libSymName, libSymCapacity * sizeof(char *));
+        if (names) libSymName = names;
+        datas = (char **)realloc(libSymData, libSymCapacity * sizeof(char *));
+        if (datas) libSymData = datas;
+        sizes = (long *)realloc(libSymSize, libSymCapacity * sizeof(long));
+        if (sizes) libSymSize = sizes;
+        if (!names || !datas || !sizes) {
+            libSymCapacity = libSymCount;
+            return 1;
+        }
+    }
+    name = (char *)malloc(strlen(module) + 1);
+    copy = (char *)malloc(size > 0 ? size : 1);
+    if (!name || !copy) {
+        free(name);
+        free(copy);
+        return 1;
+    }
+    strcpy(name, module);
+    memcpy(copy, data, size);
+    libSymName[libSymCount] = name;
+    libSymData[libSymCount] = copy;
+    libSymSize[libSymCount++] = size;
+    return 0;
+}
+
+void sobtRelease(void) {
+    int i;
+    for (i = 0; i < BUFCOUNT; i++) {
+        if (bufferSize[i] > 0) free(bufferData[i]);
+        bufferData[i] = NULL;
+        bufferLen[i] = 0;
+        bufferSize[i] = 0;
+    }
+    for (i = 0; i < libSymCount; i++) {
+        free(libSymName[i]);
+        free(libSymData[i]);
+    }
+    free(libSymName);
+    free(libSymData);
+    free(libSymSize);
+    libSymName = NULL;
+    libSymData = NULL;
+    libSymSize = NULL;
+    libSymCount = 0;
+    libSymCapacity = 0;
+    free(profileData);
+    profileData = NULL;
+    free(symbolTable);
+    free(symbolTableType);
+    free(symbolTableId);
+    free(symbolTableDataType);
+    free(symbolTableLevel);
+    free(symbolTableNext);
+    free(symbolTableFact);
+    free(symbolTableIntValue);
+    free(symbolTableRealValue);
+    free(symbolTableHash);
+    free(symbolTableNameBuffer);
+    symbolTable = NULL;
+    symbolTableType = NULL;
+    symbolTableId = NULL;
+    symbolTableDataType = NULL;
+    symbolTableLevel = NULL;
+    symbolTableNext = NULL;
+    symbolTableFact = NULL;
+    symbolTableIntValue = NULL;
+    symbolTableRealValue = NULL;
+    symbolTableHash = NULL;
+    symbolTableNameBuffer = NULL;
+    symbolTableCapacity = 0;
+    symbolTableHashSize = 0;
+    symbolTableNameBufferSize = 0;
+    free(typeForm);
+    free(typeBase);
+    free(typeLen);
+    typeForm = NULL;
+    typeBase = NULL;
+    typeLen = NULL;
+    typeTableCapacity = 0;
+    free(fieldNames);
+    free(fieldType);
+    free(fieldName);
+    free(fieldDecl);
+    free(fieldMark);
+    free(fieldOrder);
+    fieldNames = NULL;
+    fieldType = NULL;
+    fieldName = NULL;
+    fieldDecl = NULL;
+    fieldMark = NULL;
+    fieldOrder = NULL;
+    fieldNamesCapacity = 0;
+    fieldCapacity = 0;
+    free(irKind);
+    free(irStart);
+    free(irEnd);
+    free(irValue);
+    free(irLine);
+    free(irBranch);
+    irKind = NULL;
+    irStart = NULL;
+    irEnd = NULL;
+    irValue = NULL;
+    irLine = NULL;
+    irBranch = NULL;
+    irCapacity = 0;
+    free(branchLine);
+    free(branchMulti);
+    branchLine = NULL;
+    branchMulti = NULL;
+    branchCapacity = 0;
+    free(profileTotal);
+    free(profileTaken);
+    profileTotal = NULL;
+    profileTaken = NULL;
+    profileCapacity = 0;
+    free(profSig);
+    free(profBody);
+    free(profWrap);
+    free(profSplit);
+    free(profExp);
+    free(profHot);
+    free(profLeaf);
+    profSig = NULL;
+    profBody = NULL;
+    profWrap = NULL;
+    profSplit = NULL;
+    profExp = NULL;
+    profHot = NULL;
+    profLeaf = NULL;
+    profProcCapacity = 0;
+    free(guardLen);
+    free(guardLine);
+    free(guardState);
+    free(guardLoop);
+    guardLen = NULL;
+    guardLine = NULL;
+    guardState = NULL;
+    guardLoop = NULL;
+    guardCapacity = 0;
+    free(loopVar);
+    free(loopBound);
+    free(loopOpen);
+    free(loopMods);
+    free(loopLowSafe);
+    free(loopFirstGuard);
+    free(loopFloorSaved);
+    loopVar = NULL;
+    loopBound = NULL;
+    loopOpen = NULL;
+    loopMods = NULL;
+    loopLowSafe = NULL;
+    loopFirstGuard = NULL;
+    loopFloorSaved = NULL;
+    free(loopCaseDepth);
+    free(loopExit);
+    free(loopFor);
+    free(loopCounter);
+    loopCaseDepth = NULL;
+    loopExit = NULL;
+    loopFor = NULL;
+    loopCounter = NULL;
+    loopCapacity = 0;
+    free(caseLow);
+    free(caseHigh);
+    free(caseArm);
+    free(caseOf);
+    caseLow = NULL;
+    caseHigh = NULL;
+    caseArm = NULL;
+    caseOf = NULL;
+    caseLabelCapacity = 0;
+    free(caseFirst);
+    free(caseEnd);
+    free(caseForm);
+    free(caseBreak);
+    caseFirst = NULL;
+    caseEnd = NULL;
+    caseForm = NULL;
+    caseBreak = NULL;
+    caseCapacity = 0;
+    free(symTypeMap);
+    free(symTypeOrder);
+    symTypeMap = NULL;
+    symTypeOrder = NULL;
+    free(importIds);
+    importIds = NULL;
+    importCapacity = 0;
+}
+
+#endif
+
+char *copyString(const char *s, int len) {
+    char *r = (char *)malloc(len + 1);
+    if (r == NULL) fatalError("Out of memory");
+    memcpy(r, s, len);
+    r[len] = 0;
+    return r;
+}
+
+void scanModuleImports(char *src) {
+    int i;
+    char *name;
+    initCompiler();
+    strcpy(sourceFileName, src);
+    loadSource();
+    nextToken();
+    matchSymbol(TMODULE, "MODULE expected");
+    depModule[depCount] = copyString(currentToken, (int)strlen(currentToken));
+    matchSymbol(TIDENT, "Identifier expected");
+    matchSymbol(TSEMICOL, "; expected");
+    parseImportList();
+    depFile[depCount] = src;
+    depImportStart[depCount] = depImportTotal;
+    depImportCount[depCount] = importCount;
+    for (i = 0; i < importCount; i++) {
+        if (depImportTotal >= depImportCapacity) {
+            depImportCapacity = depImportCapacity ? depImportCapacity * 2 : 64;
+            depImports = (char **)growArray(depImports, depImportCapacity, sizeof(char *));
+            depImportModule = (int *)growArray(depImportModule, depImportCapacity, sizeof(int));
+        }
+        name = &symbolTableNameBuffer[symbolTable[importIds[i]]];
+        depImports[depImportTotal++] = copyString(name, (int)strlen(name));
+    }
+    depCount++;
+    cleanupFiles();
+}
+
+void visitDependency(int m) {
+    int i, k, dep;
+    if (depState[m] == 2) return;
+    depStack[depStackPtr++] = m;
+    if (depState[m] == 1) {
+        for (k = 0; depStack[k] != m; k++) { }
+        printf("Import cycle:");
+        for (; k < depStackPtr; k++) printf(" %s", depModule[depStack[k]]);
+        printf("\n");
+        exit(1);
+    }
+    depState[m] = 1;
+    for (i = 0; i < depImportCount[m]; i++) {
+        dep = depImportModule[depImportStart[m] + i];
+        if (dep >= 0) visitDependency(dep);
+    }
+    depState[m] = 2;
+    depStackPtr--;
+    depOrder[depOrderCount++] = m;
+}
+
+void appendOutputName(int b, int m, const char *ext) {
+    char *dot = strrchr(depFile[m], '.');
+    bufferAppendRange(b, depFile[m], dot ? (long)(dot - depFile[m]) : (long)strlen(depFile[m]));
+    bufferAppend(b, ext);
+}
+
+void writeDependencyFile(int m) {
+    int i, dep;
+    bufferReset(BUFC);
+    appendOutputName(BUFC, m, ".c ");
+    appendOutputName(BUFC, m, ".h ");
+    appendOutputName(BUFC, m, ".sym: ");
+    bufferAppend(BUFC, depFile[m]);
+    for (i = 0; i < depImportCount[m]; i++) {
+        dep = depImportModule[depImportStart[m] + i];
+        if (dep >= 0) {
+            bufferAppend(BUFC, " ");
+            appendOutputName(BUFC, dep, ".sym");
+        }
+    }
+    bufferAppend(BUFC, "\n");
+    appendOutputName(BUFC, m, ".o: ");
+    appendOutputName(BUFC, m, ".c ");
+    appendOutputName(BUFC, m, ".h");
+    for (i = 0; i < depImportCount[m]; i++) {
+        dep = depImportModule[depImportStart[m] + i];
+        if (dep >= 0) {
+            bufferAppend(BUFC, " ");
+            appendOutputName(BUFC, dep, ".h");
+        }
+    }
+    bufferAppend(BUFC, "\n");
+    bufferReset(BUFARGS);
+    appendOutputName(BUFARGS, m, ".d");
+    strcpy(outputNameC, bufferData[BUFARGS]);
+    bufferFlush(BUFC, outputNameC, 0);
+}
+
+int scanCaught(char *file) {
+    if (setjmp(translationAbort)) return 1;
+    scanModuleImports(file);
+    return 0;
+}
+
+void scanDependencies(char **files, int count) {
+    int i;
+    depFile = (char **)growArray(depFile, count, sizeof(char *));
+    depModule = (char **)growArray(depModule, count, sizeof(char *));
+    depImportStart = (int *)growArray(depImportStart, count, sizeof(int));
+    depImportCount = (int *)growArray(depImportCount, count, sizeof(int));
+    depState = (int *)growArray(depState, count, sizeof(int));
+    depOrder = (int *)growArray(depOrder, count, sizeof(int));
+    depStack = (int *)growArray(depStack, count + 1, sizeof(int));
+    depCount = depImportTotal = depOrderCount = depStackPtr = 0;
+    for (i = 0; i < count; i++) {
+        if (!errorJump) scanModuleImports(files[i]);
+        else if (scanCaught(files[i])) {
+            depModule[depCount] = copyString("", 0);
+            depFile[depCount] = files[i];
+            depImportStart[depCount] = depImportTotal;
+            depImportCount[depCount++] = 0;
+        }
+        depState[i] = 0;
+    }
+}
+
+int printDependencies(char **files, int count) {
+    int i, k;
+    scanDependencies(files, count);
+    for (i = 0; i < count; i++) {
+        for (k = 0; k < i; k++) {
+            if (strcmp(depModule[k], depModule[i]) == 0) {
+                printf("%s: Module %s already defined in %s\n", files[i], depModule[i], files[k]);
+                return 1;
+            }
+        }
+    }
+    for (i = 0; i < depImportTotal; i++) {
+        depImportModule[i] = -1;
+        for (k = 0; k < depCount; k++) {
+            if (strcmp(depImports[i], depModule[k]) == 0) depImportModule[i] = k;
+        }
+    }
+    for (i = 0; i < depCount; i++) visitDependency(i);
+    for (i = 0; i < depOrderCount; i++) {
+        printf("%s\n", depFile[depOrder[i]]);
+        writeDependencyFile(depOrder[i]);
+    }
+    return 0;
+}
+
+#ifdef HAVEFORK
+int readSome(int fd, char **log, long *len, long *size) {
+    int n;
+    if (*len + 256 + 1 > *size) {
+        *size = *size ? *size * 2 : 1024;
+        *log = (char *)realloc(*log, *size);
+        if (*log == NULL) {
+            printf("Error: Out of memory\n");
+            exit(1);
+        }
+    }
+    n = (int)read(fd, *log + *len, 256);
+    if (n > 0) *len += n;
+    (*log)[*len] = 0;
+    return n;
+}
+
+char *readAll(int fd) {
+    char *log = NULL;
+    long len = 0, size = 0;
+    while (readSome(fd, &log, &len, &size) > 0);
+    return log;
+}
+
+int importsModule(int m, const char *name) {
+    int i;
+    for (i = 0; i < depImportCount[m]; i++) {
+        if (strcmp(depImports[depImportStart[m] + i], name) == 0) return 1;
+    }
+    return 0;
+}
+
+int jobWaits(int m, int *done) {
+    int k;
+    for (k = 0; k < m; k++) {
+        if (done[k] || depModule[m][0] == 0 || depModule[k][0] == 0) continue;
+        if (strcmp(depModule[k], depModule[m]) == 0 || importsModule(m, depModule[k]) || importsModule(k, depModule[m])) return 1;
+    }
+    return 0;
+}
+
+int compileModulesParallel(char **files, int count, int jobs) {
+    int *pids, *fds, *done, *failed, *slot;
+    long *logLen, *logSize;
+    char **logs;
+    struct pollfd *polls;
+    int started = 0, running = 0, printed = 0, errors = 0;
+    int i, j, k, st, fd[2];
+    pid_t pid;
+    pids = (int *)calloc(count, sizeof(int));
+    fds = (int *)calloc(count, sizeof(int));
+    done = (int *)calloc(count, sizeof(int));
+    failed = (int *)calloc(count, sizeof(int));
+    slot = (int *)calloc(jobs, sizeof(int));
+    logLen = (long *)calloc(count, sizeof(long));
+    logSize = (long *)calloc(count, sizeof(long));
+    logs = (char **)calloc(count, sizeof(char *));
+    polls = (struct pollfd *)calloc(jobs, sizeof(struct pollfd));
+    if (!pids || !fds || !done || !failed || !slot || !logLen || !logSize || !logs || !polls) {
+        printf("Error: Out of memory\n");
+        return 1;
+    }
+    diagToBuffer = 1;
+    errorJump = 1;
+    scanDependencies(files, count);
+    diagToBuffer = 0;
+    errorJump = 0;
+    while (printed < count) {
+        while (running < jobs && started < count) {
+            for (i = 0; i < count && (pids[i] || done[i] || jobWaits(i, done)); i++) { }
+            if (i == count) break;
+            started++;
+            fflush(stdout);
+            if (pipe(fd) != 0 || (pid = fork()) < 0) {
+                printf("Error: Cannot start job for %s\n", files[i]);
+                done[i] = failed[i] = 1;
+                continue;
+            }
+            if (pid == 0) {
+                close(fd[0]);
+                dup2(fd[1], 1);
+                close(fd[1]);
+                compileModule(files[i]);
+                fflush(stdout);
+                _exit(0);
+            }
+            close(fd[1]);
+            pids[i] = (int)pid;
+            fds[i] = fd[0];
+            running++;
+        }
+        if (running > 0) {
+            k = 0;
+            for (i = 0; i < count; i++) {
+                if (!pids[i] || done[i]) continue;
+                polls[k].fd = fds[i];
+                polls[k].events = POLLIN;
+                polls[k].revents = 0;
+                slot[k++] = i;
+            }
+            if (poll(polls, k, -1) > 0) {
+                for (j = 0; j < k; j++) {
+                    if (polls[j].revents == 0) continue;
+                    i = slot[j];
+                    if (readSome(fds[i], &logs[i], &logLen[i], &logSize[i]) > 0) continue;
+                    close(fds[i]);
+                    waitpid((pid_t)pids[i], &st, 0);
+                    failed[i] = !WIFEXITED(st) || WEXITSTATUS(st) != 0;
+                    done[i] = 1;
+                    running--;
+                }
+            }
+        }
+        while (printed < count && done[printed]) {
+            if (logs[printed]) {
+                fputs(logs[printed], stdout);
+                if (statsMode) statsParse(logs[printed]);
+                free(logs[printed]);
+            }
+            if (failed[printed]) errors++;
+            printed++;
+        }
+    }
+    free(pids);
+    free(fds);
+    free(done);
+    free(failed);
+    free(slot);
+    free(logLen);
+    free(logSize);
+    free(logs);
+    free(polls);
+    return errors ? 1 : 0;
+}
+
+void writeAll(int fd, const char *s, long len) {
+    long n;
+    while (len > 0 && (n = (long)write(fd, s, len)) > 0) {
+        s += n;
+        len -= n;
+    }
+}
+
+int compileCaught(char *file) {
+    if (setjmp(translationAbort)) return 1;
+    compileModule(file);
+    return 0;
+}
+
+int optionCaught(char *opt) {
+    if (setjmp(translationAbort)) return 1;
+    setOption(opt);
+    return 0;
+}
+
+int serveRequest(char *request) {
+    char *p, *end;
+    int i, errors = 0;
+    bufferReset(BUFDIAG);
+    resetOptions();
+    for (i = 0; i < STATCOUNT; i++) statsTotal[i] = 0;
+    statsModules = 0;
+    for (p = request; *p; p++) {
+        if (*p == '\n') *p = 0;
+    }
+    end = p;
+    if (strlen(request) + 2 > MAXFNAMELEN || chdir(request) != 0) {
+        diagnostic("Error: Cannot change to %s\n", request);
+        return 1;
+    }
+    strcpy(serverDir, request);
+    strcat(serverDir, "/");
+    for (p = request + strlen(request) + 1; p < end; p += strlen(p) + 1) {
+        if (p[0] != '-' || p[1] == 'j' || strlen(p) >= MAXFNAMELEN) continue;
+        if (strcmp(p, "-i") == 0) incrementalMode = 1;
+        else if (strcmp(p, "-stats") == 0) statsMode = 1;
+        else if (strcmp(p, "-stop") == 0) serverStop = 1;
+        else if (strcmp(p, "-deps") == 0) {
+            diagnostic("Error: -deps is not available in server mode\n");
+            errors++;
+        } else errors += optionCaught(p);
+    }
+    if (statsMode && statsTimer == 0) statsCalibrate();
+    for (p = request + strlen(request) + 1; p < end && errors == 0; p += strlen(p) + 1) {
+        if (p[0] != '-' && strlen(p) < MAXFNAMELEN) errors += compileCaught(p);
+    }
+    if (statsMode) statsPrint("*", statsTotal);
+    return errors ? 1 : 0;
+}
+
+int runServer(const char *path) {
+    struct sockaddr_un addr;
+    char dir[MAXFNAMELEN], status[16];
+    char *request;
+    int s, c;
+    if (strlen(path) >= sizeof(addr.sun_path) || !getcwd(dir, sizeof(dir))) {
+        printf("Error: Cannot listen on %s\n", path);
+        return 1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    unlink(path);
+    s = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (s < 0 || bind(s, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(s, 16) != 0) {
+        printf("Error: Cannot listen on %s\n", path);
+        return 1;
+    }
+    signal(SIGPIPE, SIG_IGN);
+    serverMode = 1;
+    diagToBuffer = 1;
+    errorJump = 1;
+    while (!serverStop) {
+        c = accept(s, NULL, NULL);
+        if (c < 0) continue;
+        request = readAll(c);
+        sprintf(status, "%d\n", serveRequest(request));
+        free(request);
+        if (chdir(dir) != 0) serverStop = 1;
+        writeAll(c, status, (long)strlen(status));
+        writeAll(c, bufferData[BUFDIAG], bufferLen[BUFDIAG]);
+        close(c);
+    }
+    close(s);
+    unlink(path);
+    return 0;
+}
+
+int connectServer(const char *path, int argc, char **argv) {
+    struct sockaddr_un addr;
+    char dir[MAXFNAMELEN];
+    char *reply, *text;
+    int s, i;
+    if (strlen(path) >= sizeof(addr.sun_path) || !getcwd(dir, sizeof(dir))) {
+        printf("Error: Cannot connect to %s\n", path);
+        return 1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    s = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (s < 0 || connect(s, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        printf("Error: Cannot connect to %s\n", path);
+        return 1;
+    }
+    bufferReset(BUFDIAG);
+    bufferAppend(BUFDIAG, dir);
+    bufferAppend(BUFDIAG, "\n");
+    for (i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "-connect=", 9) == 0) continue;
+        bufferAppend(BUFDIAG, argv[i]);
+        bufferAppend(BUFDIAG, "\n");
+    }
+    writeAll(s, bufferData[BUFDIAG], bufferLen[BUFDIAG]);
+    shutdown(s, SHUT_WR);
+    reply = readAll(s);
+    close(s);
+    text = strchr(reply, '\n');
+    i = text ? atoi(reply) : 1;
+    if (text) fputs(text + 1, stdout);
+    else printf("Error: No reply from %s\n", path);
+    free(reply);
+    return i;
+}
+#endif
+
+#ifdef HAVEINOTIFY
+int isModuleFile(const char *name) {
+    int len = (int)strlen(name);
+    return len > 4 && name[len - 4] == '.' && tolower((unsigned char)name[len - 3]) == 'm' &&
+        tolower((unsigned char)name[len - 2]) == 'o' && tolower((unsigned char)name[len - 1]) == 'd';
+}
+
+void watchAdd(const char *file) {
     int i;
+    for (i = watchHead; i < watchCount; i++) {
+        if (strcmp(watchQueue[i], file) == 0) return;
+    }
+    if (watchCount >= watchCapacity) {
+        watchCapacity = watchCapacity ? watchCapacity * 2 : 16;
+        watchQueue = (char **)growArray(watchQueue, watchCapacity, sizeof(char *));
+    }
+    watchQueue[watchCount++] = copyString(file, (int)strlen(file));
+}
+
+int moduleImports(char *file, const char *mod) {
+    int i;
+    if (setjmp(translationAbort)) return 0;
+    initCompiler();
+    strcpy(sourceFileName, file);
+    loadSource();
+    nextToken();
+    matchSymbol(TMODULE, "MODULE expected");
+    matchSymbol(TIDENT, "Identifier expected");
+    matchSymbol(TSEMICOL, "; expected");
+    parseImportList();
+    cleanupFiles();
+    for (i = 0; i < importCount; i++) {
+        if (strcmp(&symbolTableNameBuffer[symbolTable[importIds[i]]], mod) == 0) return 1;
+    }
+    return 0;
+}
+
+int watchDirectory(const char *dir) {
+    long events[1024];
+    struct inotify_event *e;
+    char mod[MAXIDLEN];
+    char *p, *file;
+    DIR *d;
+    struct dirent *de;
+    int fd, n, failed;
+    double t;
+    fd = inotify_init();
+    if (chdir(dir) != 0 || !getcwd(serverDir, MAXFNAMELEN - 1) || fd < 0 ||
+        inotify_add_watch(fd, ".", IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        printf("Error: Cannot watch %s\n", dir);
+        return 1;
+    }
+    strcat(serverDir, "/");
+    serverMode = 2;
+    diagToBuffer = 1;
+    errorJump = 1;
+    incrementalMode = 1;
+    printf("watch dir=%s\n", serverDir);
+    fflush(stdout);
+    while ((n = (int)read(fd, events, sizeof(events))) > 0) {
+        watchHead = 0;
+        watchCount = 0;
+        for (p = (char *)events; p < (char *)events + n; p += sizeof(struct inotify_event) + e->len) {
+            e = (struct inotify_event *)p;
+            if (e->len > 0 && isModuleFile(e->name)) watchAdd(e->name);
+        }
+        while (watchHead < watchCount) {
+            file = watchQueue[watchHead++];
+            bufferReset(BUFDIAG);
+            t = statsNow();
+            failed = compileCaught(file);
+            fputs(bufferData[BUFDIAG], stdout);
+            printf("watch file=%s status=%s ms=%.3f\n", file, failed ? "error" : symChanged ? "interface" : "ok",
+                (statsNow() - t) * 1000);
+            if (!failed && symChanged) {
+                strcpy(mod, moduleName);
+                d = opendir(".");
+                while (d && (de = readdir(d)) != NULL) {
+                    if (isModuleFile(de->d_name) && strcmp(de->d_name, file) != 0 && moduleImports(de->d_name, mod)) {
+                        watchAdd(de->d_name);
+                    }
+                }
+                if (d) closedir(d);
+            }
+            free(file);
+            fflush(stdout);
+        }
+    }
+    close(fd);
+    return 1;
+}
+#endif
+
+#ifndef SOBTLIB
+int main(int argc, char **argv) {
+    int i, count = 0, jobs = 1, depsMode = 0;
+    char **files;
+    char *serverPath = NULL, *watchPath = NULL;
     if (argc == 1) {
-        printf("Usage:\n\t%s filename.mod\n", argv[0]);
+        printf("Usage:\n\t%s [-jN] [-i] [-O] [-bounds] [-lines] [-prof] [-prof-gen] [-prof-use=file] [-layout] [-goto] [-stats] filename.mod ...\n\t%s -deps filename.mod ...\n", argv[0], argv[0]);
+        printf("\t%s -server=socket\n\t%s -connect=socket [options] filename.mod ...\n\t%s [options] -watch=dir\n", argv[0], argv[0], argv[0]);
         return 1;
     }
+    files = (char **)malloc(argc * sizeof(char *));
+    if (!files) return 1;
     for(i = 1; i < argc; i++) {
         if (strlen(argv[i]) < MAXFNAMELEN) {
             if(argv[i][0] != '-') {
-                compileModule(argv[i]);
+                files[count++] = argv[i];
+            } else if (argv[i][1] == 'j') {
+                jobs = atoi(argv[i] + 2);
+#ifdef HAVEFORK
+                if (argv[i][2] == 0) jobs = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+                if (jobs < 1) jobs = 1;
+            } else if (strcmp(argv[i], "-i") == 0) {
+                incrementalMode = 1;
+            } else if (strcmp(argv[i], "-deps") == 0) {
+                depsMode = 1;
+            } else if (strcmp(argv[i], "-stats") == 0) {
+                statsMode = 1;
+#ifdef HAVEFORK
+            } else if (strncmp(argv[i], "-connect=", 9) == 0) {
+                free(files);
+                return connectServer(argv[i] + 9, argc, argv);
+            } else if (strncmp(argv[i], "-server=", 8) == 0) {
+                serverPath = argv[i] + 8;
+            } else if (strncmp(argv[i], "-watch=", 7) == 0) {
+                watchPath = argv[i] + 7;
+#endif
+            } else {
+                setOption(argv[i]);
             }
         }
     }
+    if (statsMode) statsCalibrate();
+#ifdef HAVEFORK
+    if (serverPath) {
+        free(files);
+        return runServer(serverPath);
+    }
+#endif
+#ifdef HAVEINOTIFY
+    if (watchPath) {
+        free(files);
+        return watchDirectory(watchPath);
+    }
+#endif
+    if (depsMode) {
+        i = printDependencies(files, count);
+        free(files);
+        return i;
+    }
+#ifdef HAVEFORK
+    if (jobs > 1 && count > 1) {
+        i = compileModulesParallel(files, count, jobs);
+        if (statsMode) statsPrint("*", statsTotal);
+        free(files);
+        return i;
+    }
+#endif
+    for(i = 0; i < count; i++) {
+        compileModule(files[i]);
+    }
+    if (statsMode) statsPrint("*", statsTotal);
+    free(files);
     return 0;
 }
+#endif
@@ -0,0 +1,36 @@
+#ifndef SOBT_H
+#define SOBT_H
+
+/* Translator library, built from sobt.c with -DSOBTLIB.
+   The translator state is thread-local: every thread is its own
+   translation context and several threads may translate at once. */
+
+#define SOBTC 0
+#define SOBTH 1
+#define SOBTSYM 2
+#define SOBTDIAG 3
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* translates source[0..size) as fileName with the command line options
+   in options ("-O -bounds", may be NULL), returns 0 or 1 on error */
+int sobtTranslate(const char *fileName, const char *source, long size, const char *options);
+
+/* output of the last sobtTranslate in this thread: SOBTC, SOBTH, SOBTSYM
+   or SOBTDIAG, valid until the next call */
+const char *sobtOutput(int kind, long *size);
+
+/* registers the .sym data of an imported module for this thread,
+   used instead of module.sym next to fileName, returns 0 or 1 */
+int sobtAddSymbols(const char *module, const char *data, long size);
+
+/* frees the memory held by this thread's context */
+void sobtRelease(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,78 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sobt.h"
+
+/* Library round trip for test21: translates test21a.mod and test21.mod
+   from memory with the symbols of test21a registered instead of a .sym
+   file, releases the context and translates test21.mod again. */
+
+static char *symData;
+static long symSize;
+
+static char *readFile(const char *name, long *size) {
+    FILE *f = fopen(name, "rb");
+    char *p;
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    *size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    p = (char *)malloc(*size + 1);
+    if (p) *size = (long)fread(p, 1, *size, f);
+    fclose(f);
+    return p;
+}
+
+static int writeOutput(int kind, const char *name) {
+    FILE *f = fopen(name, "wb");
+    long size;
+    const char *data = sobtOutput(kind, &size);
+    if (!f) return 1;
+    fwrite(data, 1, size, f);
+    fclose(f);
+    return 0;
+}
+
+static int translate(const char *module, int write) {
+    char name[64];
+    long size;
+    char *source;
+    int r;
+    sprintf(name, "%s.mod", module);
+    source = readFile(name, &size);
+    if (!source) {
+        printf("Cannot open %s\n", name);
+        exit(1);
+    }
+    r = sobtTranslate(name, source, size, "");
+    free(source);
+    if (r != 0 || !write) return r;
+    sprintf(name, "%s.c", module);
+    if (writeOutput(SOBTC, name)) return 1;
+    sprintf(name, "%s.h", module);
+    return writeOutput(SOBTH, name);
+}
+
+int main(void) {
+    const char *sym;
+    long size;
+    if (translate("test21a", 1)) goto failed;
+    sym = sobtOutput(SOBTSYM, &symSize);
+    symData = (char *)malloc(symSize + 1);
+    memcpy(symData, sym, symSize);
+    if (sobtAddSymbols("test21a", symData, symSize)) goto failed;
+    if (translate("test21", 0)) goto failed;
+    sobtRelease();
+    if (translate("test21", 0) == 0) {
+        printf("test21a still registered after sobtRelease\n");
+        return 1;
+    }
+    if (sobtAddSymbols("test21a", symData, symSize)) goto failed;
+    if (translate("test21", 1)) goto failed;
+    sobtRelease();
+    free(symData);
+    return 0;
+failed:
+    printf("%s", sobtOutput(SOBTDIAG, &size));
+    return 1;
+}
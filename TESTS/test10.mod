@@ -0,0 +1,39 @@
+MODULE Test10;
+
+VAR
+sp*, errors: INTEGER;
+stack: ARRAY 64 OF INTEGER;
+
+PROCEDURE Fail;
+BEGIN
+  INC(errors)
+END Fail;
+
+PROCEDURE Push*(v: INTEGER);
+BEGIN
+  IF sp >= 64 THEN
+    Fail
+  ELSE
+    stack[sp] := v;
+    INC(sp)
+  END
+END Push;
+
+PROCEDURE Fill*(n: INTEGER);
+VAR i: INTEGER;
+BEGIN
+  i := 0;
+  sp := 0;
+  WHILE i < n DO
+    IF ODD(i) THEN Push(i) ELSIF i > 10 THEN Push(1) END;
+    INC(i)
+  END;
+  REPEAT
+    DEC(sp)
+  UNTIL sp <= 0
+END Fill;
+
+BEGIN
+  errors := 0;
+  Fill(60)
+END Test10.
@@ -0,0 +1,54 @@
+MODULE Test11;
+
+IMPORT SYSTEM;
+
+CONST
+SIZE = 8;
+
+TYPE
+Node* = RECORD
+  key*: INTEGER;
+  next*: POINTER TO Node
+END;
+
+Cell = RECORD
+  tag: CHAR;
+  weight: LONGREAL;
+  count+: INTEGER;
+  live+: BOOLEAN;
+  pos: RECORD x, y: REAL END;
+  name: ARRAY 6 OF CHAR
+END;
+
+Grid = ARRAY SIZE OF Cell;
+
+VAR
+cells: Grid;
+first: Node;
+head*: POINTER TO Node;
+total*: LONGREAL;
+i: INTEGER;
+
+PROCEDURE Weigh(c: Cell): LONGREAL;
+BEGIN
+  RETURN c.weight * c.pos.x
+END Weigh;
+
+BEGIN
+  i := 0;
+  WHILE i < SIZE DO
+    cells[i].count := i;
+    cells[i].live := ODD(i);
+    cells[i].weight := 1.5;
+    cells[i].pos.x := 2.0;
+    cells[i].name[0] := 41X;
+    INC(i)
+  END;
+  first.key := 7;
+  first.next := NIL;
+  head := SYSTEM.Adr(first);
+  head.next := head;
+  total := Weigh(cells[3]);
+  i := head.next.key;
+  cells[0] := cells[1]
+END Test11.
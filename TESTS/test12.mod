@@ -0,0 +1,81 @@
+MODULE Test12;
+
+TYPE
+Point = RECORD x, y: INTEGER END;
+
+VAR
+buf: ARRAY 16 OF CHAR;
+data: ARRAY 8 OF INTEGER;
+p: Point;
+total*: INTEGER;
+
+PROCEDURE Swap*(VAR a, b: INTEGER);
+VAR t: INTEGER;
+BEGIN
+  t := a;
+  a := b;
+  b := t
+END Swap;
+
+PROCEDURE Sum(v: ARRAY OF INTEGER): INTEGER;
+VAR i, s: INTEGER;
+BEGIN
+  s := 0;
+  i := 0;
+  WHILE i < LEN(v) DO
+    s := s + v[i];
+    INC(i)
+  END;
+  RETURN s
+END Sum;
+
+PROCEDURE Fill(VAR v: ARRAY OF INTEGER; x: INTEGER);
+VAR i: INTEGER;
+BEGIN
+  i := 0;
+  WHILE i < LEN(v) DO
+    v[i] := x;
+    INC(i)
+  END
+END Fill;
+
+PROCEDURE Twice(v: ARRAY OF INTEGER): INTEGER;
+BEGIN
+  RETURN Sum(v) + Sum(v)
+END Twice;
+
+PROCEDURE Length(s: ARRAY OF CHAR): INTEGER;
+VAR i: INTEGER;
+BEGIN
+  i := 0;
+  WHILE (i < LEN(s)) & (s[i] # 0X) DO INC(i) END;
+  RETURN i
+END Length;
+
+PROCEDURE Move(VAR q: Point; dx: INTEGER);
+BEGIN
+  q.x := q.x + dx;
+  INC(q.y)
+END Move;
+
+PROCEDURE Scan;
+VAR i, k: INTEGER;
+BEGIN
+  i := 0;
+  k := 1;
+  WHILE i < 8 DO
+    data[i] := i;
+    Swap(i, k);
+    INC(i)
+  END
+END Scan;
+
+BEGIN
+  Fill(data, 3);
+  total := Twice(data) + Length("hello") + LEN(buf);
+  buf[0] := 41X;
+  total := total + Length(buf);
+  Swap(data[0], data[1]);
+  Move(p, 2);
+  Scan
+END Test12.
@@ -0,0 +1,55 @@
+MODULE Test13;
+
+CONST
+N = 4;
+M = 3;
+
+TYPE
+Grid* = ARRAY N, M OF INTEGER;
+
+VAR
+g: Grid;
+h: ARRAY N OF ARRAY M OF INTEGER;
+cube: ARRAY 2, 2, 2 OF CHAR;
+total*: INTEGER;
+
+PROCEDURE Sum(v: ARRAY OF ARRAY M OF INTEGER): INTEGER;
+VAR i, j, s: INTEGER;
+BEGIN
+  s := 0;
+  i := 0;
+  WHILE i < LEN(v) DO
+    j := 0;
+    WHILE j < LEN(v[i]) DO
+      s := s + v[i, j];
+      INC(j)
+    END;
+    INC(i)
+  END;
+  RETURN s
+END Sum;
+
+PROCEDURE Set(VAR v: Grid; i, j, x: INTEGER);
+BEGIN
+  v[i][j] := x
+END Set;
+
+BEGIN
+  total := 0;
+  WHILE total < N DO
+    g[total, 0] := total;
+    g[total, 1] := 1;
+    g[total][2] := 2;
+    h[total, 1] := g[total, 1] + total;
+    INC(total)
+  END;
+  total := 0;
+  WHILE total < N DO
+    Set(g, total, 0, 1);
+    h[total, 0] := 1;
+    INC(total)
+  END;
+  cube[1, 1, 1] := 41X;
+  Set(g, 3, 2, 10);
+  total := Sum(g) + Sum(h) + LEN(cube[0])
+END Test13.
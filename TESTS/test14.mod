@@ -0,0 +1,88 @@
+MODULE Test14;
+
+CONST
+ADD = 1;
+SUB = 2;
+
+VAR
+total*: INTEGER;
+kinds: ARRAY 4 OF INTEGER;
+
+PROCEDURE Kind(c: CHAR): INTEGER;
+VAR k: INTEGER;
+BEGIN
+  CASE c OF
+    'a'..'z', 'A'..'Z': k := 1
+  | '0'..'9': k := 2
+  | ' ', 9X: k := 3
+  ELSE
+    k := 0
+  END;
+  RETURN k
+END Kind;
+
+PROCEDURE Apply(op, a, b: INTEGER): INTEGER;
+BEGIN
+  CASE op OF
+    ADD: RETURN a + b
+  | SUB: RETURN a - b
+  | 3: RETURN a * b
+  | 4, 5:
+    IF b = 0 THEN RETURN 0 END;
+    CASE op OF
+      4: RETURN a DIV b
+    | 5: RETURN a MOD b
+    END
+  ELSE
+  END;
+  RETURN -1
+END Apply;
+
+PROCEDURE Scale(x: INTEGER): INTEGER;
+VAR r: INTEGER;
+BEGIN
+  r := 0;
+  CASE x OF
+    0: r := 1
+  | 1: r := 2
+  | 2:
+    r := 3;
+    IF x > 1 THEN BREAK END;
+    r := 4
+  | 3: r := 5
+  ELSE
+  END;
+  CASE x OF
+    0..5000: r := r + 10
+  | 5001, 6000..9999: r := r + 20
+  ELSE
+    IF x < 0 THEN BREAK END;
+    r := r + 30
+  END;
+  RETURN r
+END Scale;
+
+PROCEDURE Run(n: INTEGER): INTEGER;
+VAR i, s: INTEGER;
+BEGIN
+  s := 0;
+  i := 0;
+  WHILE i < n DO
+    CASE i MOD 4 OF
+      0: INC(s)
+    | 1: s := s + 2
+    | 2: IF s > 100 THEN BREAK END
+    | 3:
+    END;
+    INC(i)
+  END;
+  RETURN s
+END Run;
+
+BEGIN
+  kinds[0] := Kind('q');
+  kinds[1] := Kind('7');
+  kinds[2] := Kind(' ');
+  kinds[3] := Kind('+');
+  total := Apply(ADD, 2, 3) + Apply(5, 17, 5) + Apply(6, 1, 1) + Run(1000) + Scale(2) + Scale(7000)
+END Test14.
@@ -0,0 +1,46 @@
+MODULE Test15;
+
+CONST
+N = 16;
+
+VAR
+data: ARRAY N OF INTEGER;
+text: ARRAY 32 OF CHAR;
+k: INTEGER;
+total*: LONGINT;
+
+PROCEDURE Sum(v: ARRAY OF INTEGER): LONGINT;
+VAR i: INTEGER; s: LONGINT;
+BEGIN
+  s := 0;
+  FOR i := 0 TO LEN(v) - 1 DO s := s + v[i] END;
+  RETURN s
+END Sum;
+
+PROCEDURE Length(s: ARRAY OF CHAR): INTEGER;
+VAR i, n: INTEGER;
+BEGIN
+  n := LEN(s);
+  FOR i := 0 TO LEN(s) - 1 DO
+    IF s[i] = 0X THEN n := i; BREAK END
+  END;
+  RETURN n
+END Length;
+
+PROCEDURE Fill(x: INTEGER);
+VAR i, j: INTEGER;
+BEGIN
+  FOR i := 0 TO N - 1 DO data[i] := x END;
+  FOR i := N - 1 TO 0 BY -2 DO data[i] := data[i] + 1 END;
+  j := 0;
+  FOR i := 1 TO x BY 3 DO INC(j) END;
+  data[0] := j
+END Fill;
+
+BEGIN
+  Fill(10);
+  text[0] := 41X;
+  text[1] := 42X;
+  total := Sum(data);
+  FOR k := 1 TO Length(text) DO total := total + k END
+END Test15.
@@ -0,0 +1,60 @@
+MODULE Test16;
+
+CONST
+N = 8;
+
+TYPE
+Vec = ARRAY N OF INTEGER;
+Buf = RECORD len: INTEGER; data: ARRAY 16 OF CHAR END;
+
+VAR
+a, b, c: Vec;
+m: ARRAY 4, N OF INTEGER;
+w: ARRAY N OF REAL;
+flags: ARRAY 32 OF BOOLEAN;
+r, s: Buf;
+total*: INTEGER;
+norm*: REAL;
+
+PROCEDURE Copy(VAR dst: Vec; src: Vec);
+BEGIN
+  dst := src
+END Copy;
+
+PROCEDURE Accumulate(VAR acc: Vec; v: Vec);
+BEGIN
+  VADD(acc, acc, v)
+END Accumulate;
+
+PROCEDURE Clear(VAR v: ARRAY OF INTEGER);
+BEGIN
+  FILL(v, 0)
+END Clear;
+
+PROCEDURE Total(v: ARRAY OF INTEGER): INTEGER;
+BEGIN
+  RETURN VSUM(v)
+END Total;
+
+BEGIN
+  FILL(a, 3);
+  FILL(b, 0);
+  FILL(flags, TRUE);
+  FILL(r.data, 'x');
+  FILL(m, 1);
+  b := a;
+  VADD(c, a, b);
+  VSCALE(c, c, 2);
+  VADD(m[1], m[0], m[0]);
+  m[2] := m[1];
+  Copy(a, c);
+  Copy(b, b);
+  Accumulate(a, b);
+  s := r;
+  s.data := r.data;
+  FILL(w, 0.5);
+  VSCALE(w, w, 3.0);
+  Clear(m[3]);
+  total := VSUM(a) + VSUM(m) + VDOT(a, b) + Total(c);
+  norm := VDOT(w, w)
+END Test16.
@@ -0,0 +1,20 @@
+MODULE Test17;
+
+IMPORT test17a;
+
+CONST
+Last = test17a.Max - 1;
+
+VAR
+total*: INTEGER;
+v: test17a.Vec;
+p: test17a.Point;
+
+BEGIN
+  v[0] := 1;
+  v[Last] := test17a.Scale;
+  p.x := 1;
+  p.y := 2;
+  test17a.Move(p, 1, -1);
+  total := test17a.Sum(v) + p.x + p.y
+END Test17.
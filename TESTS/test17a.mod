@@ -0,0 +1,27 @@
+MODULE test17a;
+
+CONST
+Max* = 8;
+Scale* = 3;
+
+TYPE
+Vec* = ARRAY Max OF INTEGER;
+Point* = RECORD
+  x*, y*: INTEGER
+END;
+
+PROCEDURE Sum*(VAR v: Vec): INTEGER;
+VAR i, s: INTEGER;
+BEGIN
+  s := 0;
+  FOR i := 0 TO Max - 1 DO s := s + v[i] END;
+  RETURN s
+END Sum;
+
+PROCEDURE Move*(VAR p: Point; dx, dy: INTEGER);
+BEGIN
+  p.x := p.x + dx * Scale;
+  p.y := p.y + dy * Scale
+END Move;
+
+END test17a.
@@ -0,0 +1,30 @@
+MODULE Test18;
+
+(* CR LF line ends, (* nested *) comments and C injection *)
+
+(*#
+#define TEST18_LIMIT 100
+*)
+
+VAR
+total*: INTEGER;
+
+(*{
+static int test18_twice(int x) {
+    return 2 * x;
+}
+*)
+
+PROCEDURE Clamp(x: INTEGER): INTEGER;
+BEGIN
+  IF x > 50 THEN
+    (*{ Test18_x = TEST18_LIMIT / 2; *)
+  END;
+  RETURN x
+END Clamp;
+
+BEGIN
+  total := Clamp(7) + Clamp(90);
+  (*{ Test18_total = test18_twice(Test18_total); *)
+  INC(total)
+END Test18.
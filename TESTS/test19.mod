@@ -0,0 +1,52 @@
+MODULE Test19;
+
+(* Keywords and built-ins are matched by exact spelling; near misses are
+   ordinary identifiers. TRUE, FALSE and NIL must not be confused with
+   LONGINT, REAL and LONGREAL. *)
+
+TYPE
+Cell = RECORD
+  next: POINTER TO Cell;
+  key: LONGINT
+END;
+Node = POINTER TO Cell;
+
+VAR
+big*: LONGINT;
+ratio*: REAL;
+exact*: LONGREAL;
+flag*, Ends, TRUEX: BOOLEAN;
+head: Node;
+Abs, Ord, LENGTH, Integer, ORx, DOs, Bys, NILS: INTEGER;
+
+PROCEDURE Begin(Record: INTEGER): INTEGER;
+VAR Var, whilE: INTEGER;
+BEGIN
+  Var := ABS(Record);
+  whilE := 0;
+  WHILE whilE < Var DO INC(whilE) END;
+  RETURN whilE
+END Begin;
+
+BEGIN
+  big := 1234567890;
+  big := big * 4;
+  ratio := 1.5;
+  big := big + FLOOR(ratio);
+  exact := 0.25;
+  exact := exact * exact;
+  flag := TRUE;
+  Ends := FALSE;
+  TRUEX := ODD(3) OR Ends;
+  head := NIL;
+  IF head = NIL THEN flag := ~flag END;
+  Abs := Begin(-5);
+  Ord := ORD('A');
+  LENGTH := ASH(1, 4);
+  Integer := ORD(CHR(66));
+  ORx := Abs DIV 2;
+  DOs := Abs MOD 2;
+  Bys := 3;
+  NILS := Abs + Ord + LENGTH + Integer + ORx + DOs + Bys;
+  ASSERT(NILS > 0)
+END Test19.
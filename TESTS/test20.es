@@ -0,0 +1,2 @@
+stats file=test20.mod lines=30 tokens=117 lookups=38 probes=22 symbols=8 types=15 c_bytes=712 h_bytes=267 avg_probe=0.58 stabsize=512
+stats file=* lines=30 tokens=117 lookups=38 probes=22 symbols=8 types=15 c_bytes=712 h_bytes=267 avg_probe=0.58 stabsize=512
@@ -0,0 +1,29 @@
+MODULE Test20;
+
+(* Translated with -stats; the timing and allocation figures are
+   stripped before the report is compared. *)
+
+CONST N = 8;
+
+VAR
+a: ARRAY N OF INTEGER;
+total*: INTEGER;
+
+PROCEDURE Sum(VAR v: ARRAY OF INTEGER): INTEGER;
+VAR i, s: INTEGER;
+BEGIN
+  s := 0;
+  FOR i := 0 TO LEN(v) - 1 DO s := s + v[i] END;
+  RETURN s
+END Sum;
+
+PROCEDURE Fill;
+VAR i: INTEGER;
+BEGIN
+  FOR i := 0 TO N - 1 DO a[i] := i * i END
+END Fill;
+
+BEGIN
+  Fill;
+  total := Sum(a)
+END Test20.
@@ -0,0 +1,21 @@
+MODULE Test21;
+
+(* Translated through the library API by sobtlib.c, with the symbols
+   of test21a registered from memory. *)
+
+IMPORT test21a;
+
+VAR
+total*: INTEGER;
+p: test21a.Pair;
+i: INTEGER;
+
+BEGIN
+  total := 0;
+  FOR i := 1 TO test21a.Size DO
+    p.lo := i;
+    p.hi := i * i;
+    total := total + test21a.Span(p)
+  END;
+  total := total + test21a.count
+END Test21.
@@ -0,0 +1,22 @@
+MODULE test21a;
+
+CONST
+Size* = 4;
+
+TYPE
+Pair* = RECORD
+  lo*, hi*: INTEGER
+END;
+
+VAR
+count*: INTEGER;
+
+PROCEDURE Span*(VAR p: Pair): INTEGER;
+BEGIN
+  INC(count);
+  RETURN p.hi - p.lo
+END Span;
+
+BEGIN
+  count := 0
+END test21a.
@@ -0,0 +1,19 @@
+MODULE Test22;
+
+(* Translated twice by a -server process through -connect, after test22a
+   and after a failing request that must leave the server running. The
+   second request registers the cached interface of test22a. *)
+
+IMPORT test22a;
+
+VAR
+total*: INTEGER;
+p: test22a.Pair;
+r: REAL;
+
+BEGIN
+  p.a := test22a.Twice(test22a.Base);
+  p.b := 1;
+  r := test22a.Half * 2.0;
+  total := p.a + p.b + FLOOR(r)
+END Test22.
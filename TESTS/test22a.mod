@@ -0,0 +1,17 @@
+MODULE test22a;
+
+CONST
+Base* = 10;
+Half* = 0.5;
+
+TYPE
+Pair* = RECORD
+  a*, b*: INTEGER
+END;
+
+PROCEDURE Twice*(x: INTEGER): INTEGER;
+BEGIN
+  RETURN x * 2
+END Twice;
+
+END test22a.
@@ -0,0 +1,7 @@
+MODULE test22b;
+
+VAR x: INTEGER;
+
+BEGIN
+  x := TRUE
+END test22b.
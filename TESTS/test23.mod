@@ -0,0 +1,49 @@
+MODULE Test23;
+
+(* A CASE without ELSE traps when no label matches. Translated with
+   -goto: Sparse becomes a switch, Wide an if chain and Dense a label
+   table. *)
+
+VAR
+total*, probe*: INTEGER;
+
+PROCEDURE Sparse(x: INTEGER): INTEGER;
+VAR r: INTEGER;
+BEGIN
+  CASE x OF
+    1: r := 10
+  | 2..3: r := 20
+  | 100: r := 30
+  END;
+  RETURN r
+END Sparse;
+
+PROCEDURE Wide(x: INTEGER): INTEGER;
+VAR r: INTEGER;
+BEGIN
+  CASE x OF
+    0..4999: r := 1
+  | 10000..19999: r := 2
+  END;
+  RETURN r
+END Wide;
+
+PROCEDURE Dense(x: INTEGER): INTEGER;
+VAR r: INTEGER;
+BEGIN
+  CASE x OF
+    0: r := 5
+  | 1: r := 6
+  | 2, 3: r := 7
+  | 5: r := 8
+  END;
+  RETURN r
+END Dense;
+
+BEGIN
+  total := Sparse(1) + Sparse(3) + Wide(7) + Wide(15000) + Dense(0) + Dense(5);
+  CASE probe OF
+    1: total := 0
+  | 3: total := 1
+  END
+END Test23.
@@ -0,0 +1,33 @@
+MODULE Test24;
+
+(* Run against LIB: In.Char must clear In.Done at the end of the input,
+   Out.Int must print a LONGINT beyond 32 bits and SYSTEM.BitNot must
+   complement every bit. *)
+
+IMPORT In, Out, SYSTEM;
+
+VAR
+ch: CHAR;
+n, big: LONGINT;
+
+BEGIN
+  In.Open;
+  n := 0;
+  In.Char(SYSTEM.Adr(ch));
+  WHILE In.Done DO
+    INC(n);
+    In.Char(SYSTEM.Adr(ch))
+  END;
+  Out.Int(n, 0); Out.Ln;
+  big := 65536;
+  big := big * big * 3;
+  Out.Int(big, 0); Out.Ln;
+  Out.Int(SYSTEM.BitNot(5), 0); Out.Ln
+END Test24.
+
+(*{
+int main(void) {
+  mod_Test24_init();
+  return 0;
+}
+*)
@@ -0,0 +1,452 @@
+MODULE Test3;
+
+VAR
+  g0*, g1, g2, g3, g4, g5, g6, g7, g8, g9: INTEGER;
+  g10*, g11, g12, g13, g14, g15, g16, g17, g18, g19: INTEGER;
+  g20*, g21, g22, g23, g24, g25, g26, g27, g28, g29: INTEGER;
+  g30*, g31, g32, g33, g34, g35, g36, g37, g38, g39: INTEGER;
+  g40*, g41, g42, g43, g44, g45, g46, g47, g48, g49: INTEGER;
+  g50*, g51, g52, g53, g54, g55, g56, g57, g58, g59: INTEGER;
+  g60*, g61, g62, g63, g64, g65, g66, g67, g68, g69: INTEGER;
+  g70*, g71, g72, g73, g74, g75, g76, g77, g78, g79: INTEGER;
+  g80*, g81, g82, g83, g84, g85, g86, g87, g88, g89: INTEGER;
+  g90*, g91, g92, g93, g94, g95, g96, g97, g98, g99: INTEGER;
+  g100*, g101, g102, g103, g104, g105, g106, g107, g108, g109: INTEGER;
+  g110*, g111, g112, g113, g114, g115, g116, g117, g118, g119: INTEGER;
+  g120*, g121, g122, g123, g124, g125, g126, g127, g128, g129: INTEGER;
+  g130*, g131, g132, g133, g134, g135, g136, g137, g138, g139: INTEGER;
+  g140*, g141, g142, g143, g144, g145, g146, g147, g148, g149: INTEGER;
+  g150*, g151, g152, g153, g154, g155, g156, g157, g158, g159: INTEGER;
+  g160*, g161, g162, g163, g164, g165, g166, g167, g168, g169: INTEGER;
+  g170*, g171, g172, g173, g174, g175, g176, g177, g178, g179: INTEGER;
+  g180*, g181, g182, g183, g184, g185, g186, g187, g188, g189: INTEGER;
+  g190*, g191, g192, g193, g194, g195, g196, g197, g198, g199: INTEGER;
+  g200*, g201, g202, g203, g204, g205, g206, g207, g208, g209: INTEGER;
+  g210*, g211, g212, g213, g214, g215, g216, g217, g218, g219: INTEGER;
+  g220*, g221, g222, g223, g224, g225, g226, g227, g228, g229: INTEGER;
+  g230*, g231, g232, g233, g234, g235, g236, g237, g238, g239: INTEGER;
+  g240*, g241, g242, g243, g244, g245, g246, g247, g248, g249: INTEGER;
+  g250*, g251, g252, g253, g254, g255, g256, g257, g258, g259: INTEGER;
+  g260*, g261, g262, g263, g264, g265, g266, g267, g268, g269: INTEGER;
+  g270*, g271, g272, g273, g274, g275, g276, g277, g278, g279: INTEGER;
+  g280*, g281, g282, g283, g284, g285, g286, g287, g288, g289: INTEGER;
+  g290*, g291, g292, g293, g294, g295, g296, g297, g298, g299: INTEGER;
+  g300*, g301, g302, g303, g304, g305, g306, g307, g308, g309: INTEGER;
+  g310*, g311, g312, g313, g314, g315, g316, g317, g318, g319: INTEGER;
+  g320*, g321, g322, g323, g324, g325, g326, g327, g328, g329: INTEGER;
+  g330*, g331, g332, g333, g334, g335, g336, g337, g338, g339: INTEGER;
+  g340*, g341, g342, g343, g344, g345, g346, g347, g348, g349: INTEGER;
+  g350*, g351, g352, g353, g354, g355, g356, g357, g358, g359: INTEGER;
+  g360*, g361, g362, g363, g364, g365, g366, g367, g368, g369: INTEGER;
+  g370*, g371, g372, g373, g374, g375, g376, g377, g378, g379: INTEGER;
+  g380*, g381, g382, g383, g384, g385, g386, g387, g388, g389: INTEGER;
+  g390*, g391, g392, g393, g394, g395, g396, g397, g398, g399: INTEGER;
+  g400*, g401, g402, g403, g404, g405, g406, g407, g408, g409: INTEGER;
+  g410*, g411, g412, g413, g414, g415, g416, g417, g418, g419: INTEGER;
+  g420*, g421, g422, g423, g424, g425, g426, g427, g428, g429: INTEGER;
+  g430*, g431, g432, g433, g434, g435, g436, g437, g438, g439: INTEGER;
+  g440*, g441, g442, g443, g444, g445, g446, g447, g448, g449: INTEGER;
+  g450*, g451, g452, g453, g454, g455, g456, g457, g458, g459: INTEGER;
+  g460*, g461, g462, g463, g464, g465, g466, g467, g468, g469: INTEGER;
+  g470*, g471, g472, g473, g474, g475, g476, g477, g478, g479: INTEGER;
+  g480*, g481, g482, g483, g484, g485, g486, g487, g488, g489: INTEGER;
+  g490*, g491, g492, g493, g494, g495, g496, g497, g498, g499: INTEGER;
+  g500*, g501, g502, g503, g504, g505, g506, g507, g508, g509: INTEGER;
+  g510*, g511, g512, g513, g514, g515, g516, g517, g518, g519: INTEGER;
+  g520*, g521, g522, g523, g524, g525, g526, g527, g528, g529: INTEGER;
+  g530*, g531, g532, g533, g534, g535, g536, g537, g538, g539: INTEGER;
+  g540*, g541, g542, g543, g544, g545, g546, g547, g548, g549: INTEGER;
+  g550*, g551, g552, g553, g554, g555, g556, g557, g558, g559: INTEGER;
+  g560*, g561, g562, g563, g564, g565, g566, g567, g568, g569: INTEGER;
+  g570*, g571, g572, g573, g574, g575, g576, g577, g578, g579: INTEGER;
+  g580*, g581, g582, g583, g584, g585, g586, g587, g588, g589: INTEGER;
+  g590*, g591, g592, g593, g594, g595, g596, g597, g598, g599: INTEGER;
+  g600*, g601, g602, g603, g604, g605, g606, g607, g608, g609: INTEGER;
+  g610*, g611, g612, g613, g614, g615, g616, g617, g618, g619: INTEGER;
+  g620*, g621, g622, g623, g624, g625, g626, g627, g628, g629: INTEGER;
+  g630*, g631, g632, g633, g634, g635, g636, g637, g638, g639: INTEGER;
+  g640*, g641, g642, g643, g644, g645, g646, g647, g648, g649: INTEGER;
+  g650*, g651, g652, g653, g654, g655, g656, g657, g658, g659: INTEGER;
+  g660*, g661, g662, g663, g664, g665, g666, g667, g668, g669: INTEGER;
+  g670*, g671, g672, g673, g674, g675, g676, g677, g678, g679: INTEGER;
+  g680*, g681, g682, g683, g684, g685, g686, g687, g688, g689: INTEGER;
+  g690*, g691, g692, g693, g694, g695, g696, g697, g698, g699: INTEGER;
+  g700*, g701, g702, g703, g704, g705, g706, g707, g708, g709: INTEGER;
+  g710*, g711, g712, g713, g714, g715, g716, g717, g718, g719: INTEGER;
+  g720*, g721, g722, g723, g724, g725, g726, g727, g728, g729: INTEGER;
+  g730*, g731, g732, g733, g734, g735, g736, g737, g738, g739: INTEGER;
+  g740*, g741, g742, g743, g744, g745, g746, g747, g748, g749: INTEGER;
+  g750*, g751, g752, g753, g754, g755, g756, g757, g758, g759: INTEGER;
+  g760*, g761, g762, g763, g764, g765, g766, g767, g768, g769: INTEGER;
+  g770*, g771, g772, g773, g774, g775, g776, g777, g778, g779: INTEGER;
+  g780*, g781, g782, g783, g784, g785, g786, g787, g788, g789: INTEGER;
+  g790*, g791, g792, g793, g794, g795, g796, g797, g798, g799: INTEGER;
+  g800*, g801, g802, g803, g804, g805, g806, g807, g808, g809: INTEGER;
+  g810*, g811, g812, g813, g814, g815, g816, g817, g818, g819: INTEGER;
+  g820*, g821, g822, g823, g824, g825, g826, g827, g828, g829: INTEGER;
+  g830*, g831, g832, g833, g834, g835, g836, g837, g838, g839: INTEGER;
+  g840*, g841, g842, g843, g844, g845, g846, g847, g848, g849: INTEGER;
+  g850*, g851, g852, g853, g854, g855, g856, g857, g858, g859: INTEGER;
+  g860*, g861, g862, g863, g864, g865, g866, g867, g868, g869: INTEGER;
+  g870*, g871, g872, g873, g874, g875, g876, g877, g878, g879: INTEGER;
+  g880*, g881, g882, g883, g884, g885, g886, g887, g888, g889: INTEGER;
+  g890*, g891, g892, g893, g894, g895, g896, g897, g898, g899: INTEGER;
+  g900*, g901, g902, g903, g904, g905, g906, g907, g908, g909: INTEGER;
+  g910*, g911, g912, g913, g914, g915, g916, g917, g918, g919: INTEGER;
+  g920*, g921, g922, g923, g924, g925, g926, g927, g928, g929: INTEGER;
+  g930*, g931, g932, g933, g934, g935, g936, g937, g938, g939: INTEGER;
+  g940*, g941, g942, g943, g944, g945, g946, g947, g948, g949: INTEGER;
+  g950*, g951, g952, g953, g954, g955, g956, g957, g958, g959: INTEGER;
+  g960*, g961, g962, g963, g964, g965, g966, g967, g968, g969: INTEGER;
+  g970*, g971, g972, g973, g974, g975, g976, g977, g978, g979: INTEGER;
+  g980*, g981, g982, g983, g984, g985, g986, g987, g988, g989: INTEGER;
+  g990*, g991, g992, g993, g994, g995, g996, g997, g998, g999: INTEGER;
+  g1000*, g1001, g1002, g1003, g1004, g1005, g1006, g1007, g1008, g1009: INTEGER;
+  g1010*, g1011, g1012, g1013, g1014, g1015, g1016, g1017, g1018, g1019: INTEGER;
+  g1020*, g1021, g1022, g1023, g1024, g1025, g1026, g1027, g1028, g1029: INTEGER;
+  g1030*, g1031, g1032, g1033, g1034, g1035, g1036, g1037, g1038, g1039: INTEGER;
+  g1040*, g1041, g1042, g1043, g1044, g1045, g1046, g1047, g1048, g1049: INTEGER;
+  g1050*, g1051, g1052, g1053, g1054, g1055, g1056, g1057, g1058, g1059: INTEGER;
+  g1060*, g1061, g1062, g1063, g1064, g1065, g1066, g1067, g1068, g1069: INTEGER;
+  g1070*, g1071, g1072, g1073, g1074, g1075, g1076, g1077, g1078, g1079: INTEGER;
+  g1080*, g1081, g1082, g1083, g1084, g1085, g1086, g1087, g1088, g1089: INTEGER;
+  g1090*, g1091, g1092, g1093, g1094, g1095, g1096, g1097, g1098, g1099: INTEGER;
+  g1100*, g1101, g1102, g1103, g1104, g1105, g1106, g1107, g1108, g1109: INTEGER;
+  g1110*, g1111, g1112, g1113, g1114, g1115, g1116, g1117, g1118, g1119: INTEGER;
+  g1120*, g1121, g1122, g1123, g1124, g1125, g1126, g1127, g1128, g1129: INTEGER;
+  g1130*, g1131, g1132, g1133, g1134, g1135, g1136, g1137, g1138, g1139: INTEGER;
+  g1140*, g1141, g1142, g1143, g1144, g1145, g1146, g1147, g1148, g1149: INTEGER;
+  g1150*, g1151, g1152, g1153, g1154, g1155, g1156, g1157, g1158, g1159: INTEGER;
+  g1160*, g1161, g1162, g1163, g1164, g1165, g1166, g1167, g1168, g1169: INTEGER;
+  g1170*, g1171, g1172, g1173, g1174, g1175, g1176, g1177, g1178, g1179: INTEGER;
+  g1180*, g1181, g1182, g1183, g1184, g1185, g1186, g1187, g1188, g1189: INTEGER;
+  g1190*, g1191, g1192, g1193, g1194, g1195, g1196, g1197, g1198, g1199: INTEGER;
+  g1200*, g1201, g1202, g1203, g1204, g1205, g1206, g1207, g1208, g1209: INTEGER;
+  g1210*, g1211, g1212, g1213, g1214, g1215, g1216, g1217, g1218, g1219: INTEGER;
+  g1220*, g1221, g1222, g1223, g1224, g1225, g1226, g1227, g1228, g1229: INTEGER;
+  g1230*, g1231, g1232, g1233, g1234, g1235, g1236, g1237, g1238, g1239: INTEGER;
+  g1240*, g1241, g1242, g1243, g1244, g1245, g1246, g1247, g1248, g1249: INTEGER;
+  g1250*, g1251, g1252, g1253, g1254, g1255, g1256, g1257, g1258, g1259: INTEGER;
+  g1260*, g1261, g1262, g1263, g1264, g1265, g1266, g1267, g1268, g1269: INTEGER;
+  g1270*, g1271, g1272, g1273, g1274, g1275, g1276, g1277, g1278, g1279: INTEGER;
+  g1280*, g1281, g1282, g1283, g1284, g1285, g1286, g1287, g1288, g1289: INTEGER;
+  g1290*, g1291, g1292, g1293, g1294, g1295, g1296, g1297, g1298, g1299: INTEGER;
+  g1300*, g1301, g1302, g1303, g1304, g1305, g1306, g1307, g1308, g1309: INTEGER;
+  g1310*, g1311, g1312, g1313, g1314, g1315, g1316, g1317, g1318, g1319: INTEGER;
+  g1320*, g1321, g1322, g1323, g1324, g1325, g1326, g1327, g1328, g1329: INTEGER;
+  g1330*, g1331, g1332, g1333, g1334, g1335, g1336, g1337, g1338, g1339: INTEGER;
+  g1340*, g1341, g1342, g1343, g1344, g1345, g1346, g1347, g1348, g1349: INTEGER;
+  g1350*, g1351, g1352, g1353, g1354, g1355, g1356, g1357, g1358, g1359: INTEGER;
+  g1360*, g1361, g1362, g1363, g1364, g1365, g1366, g1367, g1368, g1369: INTEGER;
+  g1370*, g1371, g1372, g1373, g1374, g1375, g1376, g1377, g1378, g1379: INTEGER;
+  g1380*, g1381, g1382, g1383, g1384, g1385, g1386, g1387, g1388, g1389: INTEGER;
+  g1390*, g1391, g1392, g1393, g1394, g1395, g1396, g1397, g1398, g1399: INTEGER;
+  g1400*, g1401, g1402, g1403, g1404, g1405, g1406, g1407, g1408, g1409: INTEGER;
+  g1410*, g1411, g1412, g1413, g1414, g1415, g1416, g1417, g1418, g1419: INTEGER;
+  g1420*, g1421, g1422, g1423, g1424, g1425, g1426, g1427, g1428, g1429: INTEGER;
+  g1430*, g1431, g1432, g1433, g1434, g1435, g1436, g1437, g1438, g1439: INTEGER;
+  g1440*, g1441, g1442, g1443, g1444, g1445, g1446, g1447, g1448, g1449: INTEGER;
+  g1450*, g1451, g1452, g1453, g1454, g1455, g1456, g1457, g1458, g1459: INTEGER;
+  g1460*, g1461, g1462, g1463, g1464, g1465, g1466, g1467, g1468, g1469: INTEGER;
+  g1470*, g1471, g1472, g1473, g1474, g1475, g1476, g1477, g1478, g1479: INTEGER;
+  g1480*, g1481, g1482, g1483, g1484, g1485, g1486, g1487, g1488, g1489: INTEGER;
+  g1490*, g1491, g1492, g1493, g1494, g1495, g1496, g1497, g1498, g1499: INTEGER;
+  g1500*, g1501, g1502, g1503, g1504, g1505, g1506, g1507, g1508, g1509: INTEGER;
+  g1510*, g1511, g1512, g1513, g1514, g1515, g1516, g1517, g1518, g1519: INTEGER;
+  g1520*, g1521, g1522, g1523, g1524, g1525, g1526, g1527, g1528, g1529: INTEGER;
+  g1530*, g1531, g1532, g1533, g1534, g1535, g1536, g1537, g1538, g1539: INTEGER;
+  g1540*, g1541, g1542, g1543, g1544, g1545, g1546, g1547, g1548, g1549: INTEGER;
+  g1550*, g1551, g1552, g1553, g1554, g1555, g1556, g1557, g1558, g1559: INTEGER;
+  g1560*, g1561, g1562, g1563, g1564, g1565, g1566, g1567, g1568, g1569: INTEGER;
+  g1570*, g1571, g1572, g1573, g1574, g1575, g1576, g1577, g1578, g1579: INTEGER;
+  g1580*, g1581, g1582, g1583, g1584, g1585, g1586, g1587, g1588, g1589: INTEGER;
+  g1590*, g1591, g1592, g1593, g1594, g1595, g1596, g1597, g1598, g1599: INTEGER;
+  g1600*, g1601, g1602, g1603, g1604, g1605, g1606, g1607, g1608, g1609: INTEGER;
+  g1610*, g1611, g1612, g1613, g1614, g1615, g1616, g1617, g1618, g1619: INTEGER;
+  g1620*, g1621, g1622, g1623, g1624, g1625, g1626, g1627, g1628, g1629: INTEGER;
+  g1630*, g1631, g1632, g1633, g1634, g1635, g1636, g1637, g1638, g1639: INTEGER;
+  g1640*, g1641, g1642, g1643, g1644, g1645, g1646, g1647, g1648, g1649: INTEGER;
+  g1650*, g1651, g1652, g1653, g1654, g1655, g1656, g1657, g1658, g1659: INTEGER;
+  g1660*, g1661, g1662, g1663, g1664, g1665, g1666, g1667, g1668, g1669: INTEGER;
+  g1670*, g1671, g1672, g1673, g1674, g1675, g1676, g1677, g1678, g1679: INTEGER;
+  g1680*, g1681, g1682, g1683, g1684, g1685, g1686, g1687, g1688, g1689: INTEGER;
+  g1690*, g1691, g1692, g1693, g1694, g1695, g1696, g1697, g1698, g1699: INTEGER;
+  g1700*, g1701, g1702, g1703, g1704, g1705, g1706, g1707, g1708, g1709: INTEGER;
+  g1710*, g1711, g1712, g1713, g1714, g1715, g1716, g1717, g1718, g1719: INTEGER;
+  g1720*, g1721, g1722, g1723, g1724, g1725, g1726, g1727, g1728, g1729: INTEGER;
+  g1730*, g1731, g1732, g1733, g1734, g1735, g1736, g1737, g1738, g1739: INTEGER;
+  g1740*, g1741, g1742, g1743, g1744, g1745, g1746, g1747, g1748, g1749: INTEGER;
+  g1750*, g1751, g1752, g1753, g1754, g1755, g1756, g1757, g1758, g1759: INTEGER;
+  g1760*, g1761, g1762, g1763, g1764, g1765, g1766, g1767, g1768, g1769: INTEGER;
+  g1770*, g1771, g1772, g1773, g1774, g1775, g1776, g1777, g1778, g1779: INTEGER;
+  g1780*, g1781, g1782, g1783, g1784, g1785, g1786, g1787, g1788, g1789: INTEGER;
+  g1790*, g1791, g1792, g1793, g1794, g1795, g1796, g1797, g1798, g1799: INTEGER;
+  g1800*, g1801, g1802, g1803, g1804, g1805, g1806, g1807, g1808, g1809: INTEGER;
+  g1810*, g1811, g1812, g1813, g1814, g1815, g1816, g1817, g1818, g1819: INTEGER;
+  g1820*, g1821, g1822, g1823, g1824, g1825, g1826, g1827, g1828, g1829: INTEGER;
+  g1830*, g1831, g1832, g1833, g1834, g1835, g1836, g1837, g1838, g1839: INTEGER;
+  g1840*, g1841, g1842, g1843, g1844, g1845, g1846, g1847, g1848, g1849: INTEGER;
+  g1850*, g1851, g1852, g1853, g1854, g1855, g1856, g1857, g1858, g1859: INTEGER;
+  g1860*, g1861, g1862, g1863, g1864, g1865, g1866, g1867, g1868, g1869: INTEGER;
+  g1870*, g1871, g1872, g1873, g1874, g1875, g1876, g1877, g1878, g1879: INTEGER;
+  g1880*, g1881, g1882, g1883, g1884, g1885, g1886, g1887, g1888, g1889: INTEGER;
+  g1890*, g1891, g1892, g1893, g1894, g1895, g1896, g1897, g1898, g1899: INTEGER;
+  g1900*, g1901, g1902, g1903, g1904, g1905, g1906, g1907, g1908, g1909: INTEGER;
+  g1910*, g1911, g1912, g1913, g1914, g1915, g1916, g1917, g1918, g1919: INTEGER;
+  g1920*, g1921, g1922, g1923, g1924, g1925, g1926, g1927, g1928, g1929: INTEGER;
+  g1930*, g1931, g1932, g1933, g1934, g1935, g1936, g1937, g1938, g1939: INTEGER;
+  g1940*, g1941, g1942, g1943, g1944, g1945, g1946, g1947, g1948, g1949: INTEGER;
+  g1950*, g1951, g1952, g1953, g1954, g1955, g1956, g1957, g1958, g1959: INTEGER;
+  g1960*, g1961, g1962, g1963, g1964, g1965, g1966, g1967, g1968, g1969: INTEGER;
+  g1970*, g1971, g1972, g1973, g1974, g1975, g1976, g1977, g1978, g1979: INTEGER;
+  g1980*, g1981, g1982, g1983, g1984, g1985, g1986, g1987, g1988, g1989: INTEGER;
+  g1990*, g1991, g1992, g1993, g1994, g1995, g1996, g1997, g1998, g1999: INTEGER;
+
+PROCEDURE P0(a0, b0: INTEGER): INTEGER;
+VAR
+  l0, l1, l2, l3, l4, l5, l6, l7, l8, l9: INTEGER;
+  l10, l11, l12, l13, l14, l15, l16, l17, l18, l19: INTEGER;
+  l20, l21, l22, l23, l24, l25, l26, l27, l28, l29: INTEGER;
+  l30, l31, l32, l33, l34, l35, l36, l37, l38, l39: INTEGER;
+  l40, l41, l42, l43, l44, l45, l46, l47, l48, l49: INTEGER;
+  l50, l51, l52, l53, l54, l55, l56, l57, l58, l59: INTEGER;
+  l60, l61, l62, l63, l64, l65, l66, l67, l68, l69: INTEGER;
+  l70, l71, l72, l73, l74, l75, l76, l77, l78, l79: INTEGER;
+  l80, l81, l82, l83, l84, l85, l86, l87, l88, l89: INTEGER;
+  l90, l91, l92, l93, l94, l95, l96, l97, l98, l99: INTEGER;
+  l100, l101, l102, l103, l104, l105, l106, l107, l108, l109: INTEGER;
+  l110, l111, l112, l113, l114, l115, l116, l117, l118, l119: INTEGER;
+  l120, l121, l122, l123, l124, l125, l126, l127, l128, l129: INTEGER;
+  l130, l131, l132, l133, l134, l135, l136, l137, l138, l139: INTEGER;
+  l140, l141, l142, l143, l144, l145, l146, l147, l148, l149: INTEGER;
+  l150, l151, l152, l153, l154, l155, l156, l157, l158, l159: INTEGER;
+  l160, l161, l162, l163, l164, l165, l166, l167, l168, l169: INTEGER;
+  l170, l171, l172, l173, l174, l175, l176, l177, l178, l179: INTEGER;
+  l180, l181, l182, l183, l184, l185, l186, l187, l188, l189: INTEGER;
+  l190, l191, l192, l193, l194, l195, l196, l197, l198, l199: INTEGER;
+  l200, l201, l202, l203, l204, l205, l206, l207, l208, l209: INTEGER;
+  l210, l211, l212, l213, l214, l215, l216, l217, l218, l219: INTEGER;
+  l220, l221, l222, l223, l224, l225, l226, l227, l228, l229: INTEGER;
+  l230, l231, l232, l233, l234, l235, l236, l237, l238, l239: INTEGER;
+  l240, l241, l242, l243, l244, l245, l246, l247, l248, l249: INTEGER;
+  l250, l251, l252, l253, l254, l255, l256, l257, l258, l259: INTEGER;
+  l260, l261, l262, l263, l264, l265, l266, l267, l268, l269: INTEGER;
+  l270, l271, l272, l273, l274, l275, l276, l277, l278, l279: INTEGER;
+  l280, l281, l282, l283, l284, l285, l286, l287, l288, l289: INTEGER;
+  l290, l291, l292, l293, l294, l295, l296, l297, l298, l299: INTEGER;
+  l300, l301, l302, l303, l304, l305, l306, l307, l308, l309: INTEGER;
+  l310, l311, l312, l313, l314, l315, l316, l317, l318, l319: INTEGER;
+  l320, l321, l322, l323, l324, l325, l326, l327, l328, l329: INTEGER;
+  l330, l331, l332, l333, l334, l335, l336, l337, l338, l339: INTEGER;
+  l340, l341, l342, l343, l344, l345, l346, l347, l348, l349: INTEGER;
+  l350, l351, l352, l353, l354, l355, l356, l357, l358, l359: INTEGER;
+  l360, l361, l362, l363, l364, l365, l366, l367, l368, l369: INTEGER;
+  l370, l371, l372, l373, l374, l375, l376, l377, l378, l379: INTEGER;
+  l380, l381, l382, l383, l384, l385, l386, l387, l388, l389: INTEGER;
+  l390, l391, l392, l393, l394, l395, l396, l397, l398, l399: INTEGER;
+  l400, l401, l402, l403, l404, l405, l406, l407, l408, l409: INTEGER;
+  l410, l411, l412, l413, l414, l415, l416, l417, l418, l419: INTEGER;
+  l420, l421, l422, l423, l424, l425, l426, l427, l428, l429: INTEGER;
+  l430, l431, l432, l433, l434, l435, l436, l437, l438, l439: INTEGER;
+  l440, l441, l442, l443, l444, l445, l446, l447, l448, l449: INTEGER;
+  l450, l451, l452, l453, l454, l455, l456, l457, l458, l459: INTEGER;
+  l460, l461, l462, l463, l464, l465, l466, l467, l468, l469: INTEGER;
+  l470, l471, l472, l473, l474, l475, l476, l477, l478, l479: INTEGER;
+  l480, l481, l482, l483, l484, l485, l486, l487, l488, l489: INTEGER;
+  l490, l491, l492, l493, l494, l495, l496, l497, l498, l499: INTEGER;
+  g1: INTEGER;
+BEGIN
+  l0 := a0;
+  l499 := l0 + b0;
+  g1 := l499;
+  g1990 := g1 + g1999;
+  RETURN l499
+END P0;
+
+PROCEDURE P1(a1, b1: INTEGER): INTEGER;
+VAR
+  l0, l1, l2, l3, l4, l5, l6, l7, l8, l9: INTEGER;
+  l10, l11, l12, l13, l14, l15, l16, l17, l18, l19: INTEGER;
+  l20, l21, l22, l23, l24, l25, l26, l27, l28, l29: INTEGER;
+  l30, l31, l32, l33, l34, l35, l36, l37, l38, l39: INTEGER;
+  l40, l41, l42, l43, l44, l45, l46, l47, l48, l49: INTEGER;
+  l50, l51, l52, l53, l54, l55, l56, l57, l58, l59: INTEGER;
+  l60, l61, l62, l63, l64, l65, l66, l67, l68, l69: INTEGER;
+  l70, l71, l72, l73, l74, l75, l76, l77, l78, l79: INTEGER;
+  l80, l81, l82, l83, l84, l85, l86, l87, l88, l89: INTEGER;
+  l90, l91, l92, l93, l94, l95, l96, l97, l98, l99: INTEGER;
+  l100, l101, l102, l103, l104, l105, l106, l107, l108, l109: INTEGER;
+  l110, l111, l112, l113, l114, l115, l116, l117, l118, l119: INTEGER;
+  l120, l121, l122, l123, l124, l125, l126, l127, l128, l129: INTEGER;
+  l130, l131, l132, l133, l134, l135, l136, l137, l138, l139: INTEGER;
+  l140, l141, l142, l143, l144, l145, l146, l147, l148, l149: INTEGER;
+  l150, l151, l152, l153, l154, l155, l156, l157, l158, l159: INTEGER;
+  l160, l161, l162, l163, l164, l165, l166, l167, l168, l169: INTEGER;
+  l170, l171, l172, l173, l174, l175, l176, l177, l178, l179: INTEGER;
+  l180, l181, l182, l183, l184, l185, l186, l187, l188, l189: INTEGER;
+  l190, l191, l192, l193, l194, l195, l196, l197, l198, l199: INTEGER;
+  l200, l201, l202, l203, l204, l205, l206, l207, l208, l209: INTEGER;
+  l210, l211, l212, l213, l214, l215, l216, l217, l218, l219: INTEGER;
+  l220, l221, l222, l223, l224, l225, l226, l227, l228, l229: INTEGER;
+  l230, l231, l232, l233, l234, l235, l236, l237, l238, l239: INTEGER;
+  l240, l241, l242, l243, l244, l245, l246, l247, l248, l249: INTEGER;
+  l250, l251, l252, l253, l254, l255, l256, l257, l258, l259: INTEGER;
+  l260, l261, l262, l263, l264, l265, l266, l267, l268, l269: INTEGER;
+  l270, l271, l272, l273, l274, l275, l276, l277, l278, l279: INTEGER;
+  l280, l281, l282, l283, l284, l285, l286, l287, l288, l289: INTEGER;
+  l290, l291, l292, l293, l294, l295, l296, l297, l298, l299: INTEGER;
+  l300, l301, l302, l303, l304, l305, l306, l307, l308, l309: INTEGER;
+  l310, l311, l312, l313, l314, l315, l316, l317, l318, l319: INTEGER;
+  l320, l321, l322, l323, l324, l325, l326, l327, l328, l329: INTEGER;
+  l330, l331, l332, l333, l334, l335, l336, l337, l338, l339: INTEGER;
+  l340, l341, l342, l343, l344, l345, l346, l347, l348, l349: INTEGER;
+  l350, l351, l352, l353, l354, l355, l356, l357, l358, l359: INTEGER;
+  l360, l361, l362, l363, l364, l365, l366, l367, l368, l369: INTEGER;
+  l370, l371, l372, l373, l374, l375, l376, l377, l378, l379: INTEGER;
+  l380, l381, l382, l383, l384, l385, l386, l387, l388, l389: INTEGER;
+  l390, l391, l392, l393, l394, l395, l396, l397, l398, l399: INTEGER;
+  l400, l401, l402, l403, l404, l405, l406, l407, l408, l409: INTEGER;
+  l410, l411, l412, l413, l414, l415, l416, l417, l418, l419: INTEGER;
+  l420, l421, l422, l423, l424, l425, l426, l427, l428, l429: INTEGER;
+  l430, l431, l432, l433, l434, l435, l436, l437, l438, l439: INTEGER;
+  l440, l441, l442, l443, l444, l445, l446, l447, l448, l449: INTEGER;
+  l450, l451, l452, l453, l454, l455, l456, l457, l458, l459: INTEGER;
+  l460, l461, l462, l463, l464, l465, l466, l467, l468, l469: INTEGER;
+  l470, l471, l472, l473, l474, l475, l476, l477, l478, l479: INTEGER;
+  l480, l481, l482, l483, l484, l485, l486, l487, l488, l489: INTEGER;
+  l490, l491, l492, l493, l494, l495, l496, l497, l498, l499: INTEGER;
+  g8: INTEGER;
+BEGIN
+  l0 := a1;
+  l499 := l0 + b1;
+  g8 := l499;
+  g1991 := g8 + g1999;
+  RETURN l499
+END P1;
+
+PROCEDURE P2(a2, b2: INTEGER): INTEGER;
+VAR
+  l0, l1, l2, l3, l4, l5, l6, l7, l8, l9: INTEGER;
+  l10, l11, l12, l13, l14, l15, l16, l17, l18, l19: INTEGER;
+  l20, l21, l22, l23, l24, l25, l26, l27, l28, l29: INTEGER;
+  l30, l31, l32, l33, l34, l35, l36, l37, l38, l39: INTEGER;
+  l40, l41, l42, l43, l44, l45, l46, l47, l48, l49: INTEGER;
+  l50, l51, l52, l53, l54, l55, l56, l57, l58, l59: INTEGER;
+  l60, l61, l62, l63, l64, l65, l66, l67, l68, l69: INTEGER;
+  l70, l71, l72, l73, l74, l75, l76, l77, l78, l79: INTEGER;
+  l80, l81, l82, l83, l84, l85, l86, l87, l88, l89: INTEGER;
+  l90, l91, l92, l93, l94, l95, l96, l97, l98, l99: INTEGER;
+  l100, l101, l102, l103, l104, l105, l106, l107, l108, l109: INTEGER;
+  l110, l111, l112, l113, l114, l115, l116, l117, l118, l119: INTEGER;
+  l120, l121, l122, l123, l124, l125, l126, l127, l128, l129: INTEGER;
+  l130, l131, l132, l133, l134, l135, l136, l137, l138, l139: INTEGER;
+  l140, l141, l142, l143, l144, l145, l146, l147, l148, l149: INTEGER;
+  l150, l151, l152, l153, l154, l155, l156, l157, l158, l159: INTEGER;
+  l160, l161, l162, l163, l164, l165, l166, l167, l168, l169: INTEGER;
+  l170, l171, l172, l173, l174, l175, l176, l177, l178, l179: INTEGER;
+  l180, l181, l182, l183, l184, l185, l186, l187, l188, l189: INTEGER;
+  l190, l191, l192, l193, l194, l195, l196, l197, l198, l199: INTEGER;
+  l200, l201, l202, l203, l204, l205, l206, l207, l208, l209: INTEGER;
+  l210, l211, l212, l213, l214, l215, l216, l217, l218, l219: INTEGER;
+  l220, l221, l222, l223, l224, l225, l226, l227, l228, l229: INTEGER;
+  l230, l231, l232, l233, l234, l235, l236, l237, l238, l239: INTEGER;
+  l240, l241, l242, l243, l244, l245, l246, l247, l248, l249: INTEGER;
+  l250, l251, l252, l253, l254, l255, l256, l257, l258, l259: INTEGER;
+  l260, l261, l262, l263, l264, l265, l266, l267, l268, l269: INTEGER;
+  l270, l271, l272, l273, l274, l275, l276, l277, l278, l279: INTEGER;
+  l280, l281, l282, l283, l284, l285, l286, l287, l288, l289: INTEGER;
+  l290, l291, l292, l293, l294, l295, l296, l297, l298, l299: INTEGER;
+  l300, l301, l302, l303, l304, l305, l306, l307, l308, l309: INTEGER;
+  l310, l311, l312, l313, l314, l315, l316, l317, l318, l319: INTEGER;
+  l320, l321, l322, l323, l324, l325, l326, l327, l328, l329: INTEGER;
+  l330, l331, l332, l333, l334, l335, l336, l337, l338, l339: INTEGER;
+  l340, l341, l342, l343, l344, l345, l346, l347, l348, l349: INTEGER;
+  l350, l351, l352, l353, l354, l355, l356, l357, l358, l359: INTEGER;
+  l360, l361, l362, l363, l364, l365, l366, l367, l368, l369: INTEGER;
+  l370, l371, l372, l373, l374, l375, l376, l377, l378, l379: INTEGER;
+  l380, l381, l382, l383, l384, l385, l386, l387, l388, l389: INTEGER;
+  l390, l391, l392, l393, l394, l395, l396, l397, l398, l399: INTEGER;
+  l400, l401, l402, l403, l404, l405, l406, l407, l408, l409: INTEGER;
+  l410, l411, l412, l413, l414, l415, l416, l417, l418, l419: INTEGER;
+  l420, l421, l422, l423, l424, l425, l426, l427, l428, l429: INTEGER;
+  l430, l431, l432, l433, l434, l435, l436, l437, l438, l439: INTEGER;
+  l440, l441, l442, l443, l444, l445, l446, l447, l448, l449: INTEGER;
+  l450, l451, l452, l453, l454, l455, l456, l457, l458, l459: INTEGER;
+  l460, l461, l462, l463, l464, l465, l466, l467, l468, l469: INTEGER;
+  l470, l471, l472, l473, l474, l475, l476, l477, l478, l479: INTEGER;
+  l480, l481, l482, l483, l484, l485, l486, l487, l488, l489: INTEGER;
+  l490, l491, l492, l493, l494, l495, l496, l497, l498, l499: INTEGER;
+  g15: INTEGER;
+BEGIN
+  l0 := a2;
+  l499 := l0 + b2;
+  g15 := l499;
+  g1992 := g15 + g1999;
+  RETURN l499
+END P2;
+
+PROCEDURE P3(a3, b3: INTEGER): INTEGER;
+VAR
+  l0, l1, l2, l3, l4, l5, l6, l7, l8, l9: INTEGER;
+  l10, l11, l12, l13, l14, l15, l16, l17, l18, l19: INTEGER;
+  l20, l21, l22, l23, l24, l25, l26, l27, l28, l29: INTEGER;
+  l30, l31, l32, l33, l34, l35, l36, l37, l38, l39: INTEGER;
+  l40, l41, l42, l43, l44, l45, l46, l47, l48, l49: INTEGER;
+  l50, l51, l52, l53, l54, l55, l56, l57, l58, l59: INTEGER;
+  l60, l61, l62, l63, l64, l65, l66, l67, l68, l69: INTEGER;
+  l70, l71, l72, l73, l74, l75, l76, l77, l78, l79: INTEGER;
+  l80, l81, l82, l83, l84, l85, l86, l87, l88, l89: INTEGER;
+  l90, l91, l92, l93, l94, l95, l96, l97, l98, l99: INTEGER;
+  l100, l101, l102, l103, l104, l105, l106, l107, l108, l109: INTEGER;
+  l110, l111, l112, l113, l114, l115, l116, l117, l118, l119: INTEGER;
+  l120, l121, l122, l123, l124, l125, l126, l127, l128, l129: INTEGER;
+  l130, l131, l132, l133, l134, l135, l136, l137, l138, l139: INTEGER;
+  l140, l141, l142, l143, l144, l145, l146, l147, l148, l149: INTEGER;
+  l150, l151, l152, l153, l154, l155, l156, l157, l158, l159: INTEGER;
+  l160, l161, l162, l163, l164, l165, l166, l167, l168, l169: INTEGER;
+  l170, l171, l172, l173, l174, l175, l176, l177, l178, l179: INTEGER;
+  l180, l181, l182, l183, l184, l185, l186, l187, l188, l189: INTEGER;
+  l190, l191, l192, l193, l194, l195, l196, l197, l198, l199: INTEGER;
+  l200, l201, l202, l203, l204, l205, l206, l207, l208, l209: INTEGER;
+  l210, l211, l212, l213, l214, l215, l216, l217, l218, l219: INTEGER;
+  l220, l221, l222, l223, l224, l225, l226, l227, l228, l229: INTEGER;
+  l230, l231, l232, l233, l234, l235, l236, l237, l238, l239: INTEGER;
+  l240, l241, l242, l243, l244, l245, l246, l247, l248, l249: INTEGER;
+  l250, l251, l252, l253, l254, l255, l256, l257, l258, l259: INTEGER;
+  l260, l261, l262, l263, l264, l265, l266, l267, l268, l269: INTEGER;
+  l270, l271, l272, l273, l274, l275, l276, l277, l278, l279: INTEGER;
+  l280, l281, l282, l283, l284, l285, l286, l287, l288, l289: INTEGER;
+  l290, l291, l292, l293, l294, l295, l296, l297, l298, l299: INTEGER;
+  l300, l301, l302, l303, l304, l305, l306, l307, l308, l309: INTEGER;
+  l310, l311, l312, l313, l314, l315, l316, l317, l318, l319: INTEGER;
+  l320, l321, l322, l323, l324, l325, l326, l327, l328, l329: INTEGER;
+  l330, l331, l332, l333, l334, l335, l336, l337, l338, l339: INTEGER;
+  l340, l341, l342, l343, l344, l345, l346, l347, l348, l349: INTEGER;
+  l350, l351, l352, l353, l354, l355, l356, l357, l358, l359: INTEGER;
+  l360, l361, l362, l363, l364, l365, l366, l367, l368, l369: INTEGER;
+  l370, l371, l372, l373, l374, l375, l376, l377, l378, l379: INTEGER;
+  l380, l381, l382, l383, l384, l385, l386, l387, l388, l389: INTEGER;
+  l390, l391, l392, l393, l394, l395, l396, l397, l398, l399: INTEGER;
+  l400, l401, l402, l403, l404, l405, l406, l407, l408, l409: INTEGER;
+  l410, l411, l412, l413, l414, l415, l416, l417, l418, l419: INTEGER;
+  l420, l421, l422, l423, l424, l425, l426, l427, l428, l429: INTEGER;
+  l430, l431, l432, l433, l434, l435, l436, l437, l438, l439: INTEGER;
+  l440, l441, l442, l443, l444, l445, l446, l447, l448, l449: INTEGER;
+  l450, l451, l452, l453, l454, l455, l456, l457, l458, l459: INTEGER;
+  l460, l461, l462, l463, l464, l465, l466, l467, l468, l469: INTEGER;
+  l470, l471, l472, l473, l474, l475, l476, l477, l478, l479: INTEGER;
+  l480, l481, l482, l483, l484, l485, l486, l487, l488, l489: INTEGER;
+  l490, l491, l492, l493, l494, l495, l496, l497, l498, l499: INTEGER;
+  g22: INTEGER;
+BEGIN
+  l0 := a3;
+  l499 := l0 + b3;
+  g22 := l499;
+  g1993 := g22 + g1999;
+  RETURN l499
+END P3;
+
+BEGIN
+  g0 := P0(1, 2) + P3(g1999, g1000);
+  g10 := P1(g0, g10) + P2(g20, g30)
+END Test3.
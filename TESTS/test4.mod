@@ -0,0 +1,35 @@
+MODULE Test4;
+
+CONST
+MEMSIZE* = 16000;
+DSSIZE = 128;
+BUFSZ* = MEMSIZE - DSSIZE;
+HALF = BUFSZ DIV 2;
+NEGMOD = -7 MOD 2;
+NEGDIV = -7 DIV 2;
+SHIFT = ASH(1, 10);
+SCALE* = 1.5 * 4.0;
+BIG = MEMSIZE > 1000;
+EMPTY = ~BIG OR (DSSIZE = 0);
+LETTER = CHR(ORD('A') + 1);
+CR = 0DX;
+NAME* = "sobt";
+
+VAR
+buf: ARRAY BUFSZ OF CHAR;
+stack: ARRAY DSSIZE DIV 2 + 1 OF INTEGER;
+sp, n: INTEGER;
+r: REAL;
+b: BOOLEAN;
+
+BEGIN
+      sp := 0;
+      n := HALF * 2 + sp;
+      stack[DSSIZE DIV 2] := (3 + 4) * (10 - 8);
+      IF sp > (MEMSIZE - DSSIZE) THEN sp := 0 END;
+      r := SCALE + 0.25;
+      b := ODD(NEGMOD) & BIG;
+      buf[0] := LETTER;
+      buf[1] := CR;
+      n := ABS(NEGDIV) + SHIFT
+END Test4.
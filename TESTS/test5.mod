@@ -0,0 +1,51 @@
+MODULE Test5;
+
+CONST
+DEBUG = FALSE;
+LEVEL = 2;
+
+VAR
+n*: INTEGER;
+
+PROCEDURE Clamp*(x: INTEGER): INTEGER;
+BEGIN
+  IF x < 0 THEN
+    RETURN 0;
+    x := 1
+  ELSIF x > 100 THEN
+    RETURN 100
+  END;
+  RETURN x;
+  (*{ /* kept */ *)
+  n := 0
+END Clamp;
+
+PROCEDURE Count*(limit: INTEGER): INTEGER;
+VAR i: INTEGER;
+BEGIN
+  i := 0;
+  IF DEBUG THEN
+    n := -1
+  ELSIF LEVEL > 1 THEN
+    n := 1
+  ELSE
+    n := 2
+  END;
+  WHILE DEBUG DO
+    INC(i)
+  END;
+  WHILE i < limit DO
+    INC(i);
+    IF ODD(i) THEN CONTINUE END;
+    IF i > 50 THEN BREAK; DEC(i) END
+  END;
+  REPEAT
+    DEC(i)
+  UNTIL i <= 0;
+  RETURN i
+END Count;
+
+BEGIN
+  n := Clamp(LEVEL * 3);
+  IF LEVEL = 2 THEN n := Count(n) END
+END Test5.
@@ -0,0 +1,32 @@
+MODULE Test6;
+
+CONST
+N = 8;
+
+VAR
+a*: ARRAY N OF INTEGER;
+
+PROCEDURE Sum*(k: INTEGER): INTEGER;
+VAR i, s: INTEGER;
+BEGIN
+  s := 0;
+  i := 0;
+  WHILE i < N DO
+    s := s + a[i];
+    INC(i)
+  END;
+  a[k] := a[k] + 1;
+  IF (k > 0) & (a[k] > 0) THEN s := s + a[k] END;
+  RETURN s + a[N - 1]
+END Sum;
+
+PROCEDURE Poke(p: POINTER TO INTEGER);
+BEGIN
+  p[2] := a[3]
+END Poke;
+
+BEGIN
+  a[0] := 1;
+  Poke(a);
+  a[Sum(1)] := 0
+END Test6.
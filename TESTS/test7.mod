@@ -0,0 +1,22 @@
+MODULE Test7;
+
+CONST
+SIZE = 64;
+
+VAR
+a, b, n*: INTEGER;
+h: LONGINT;
+r: REAL;
+ring: ARRAY SIZE OF INTEGER;
+
+BEGIN
+  a := -7;
+  b := 2;
+  n := a DIV b + a MOD b;
+  n := a DIV 4 + a MOD SIZE;
+  n := a MOD 4 * b;
+  h := h * 31 + a MOD (-3);
+  ring[(n + 1) MOD SIZE] := a DIV 1;
+  n := ASH(a, 3) + ASH(a, -2) + ASH(a, b);
+  r := r DIV 2.0
+END Test7.
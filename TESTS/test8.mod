@@ -0,0 +1,34 @@
+MODULE Test8;
+
+VAR
+n*: INTEGER;
+buf: ARRAY 16 OF INTEGER;
+
+(*{ static int calls = 0; *)
+
+PROCEDURE Step*(k: INTEGER): INTEGER;
+VAR i: INTEGER;
+BEGIN
+  i := 0;
+  (* count calls *)
+  (*{ calls++; *)
+  WHILE i < k DO
+    IF ODD(i) THEN
+      n := n + i
+    ELSIF i > 10 THEN
+      n := n -
+        i
+    END;
+    INC(i)
+  END;
+  REPEAT
+    DEC(i)
+  UNTIL i <= 0;
+  RETURN n
+END Step;
+
+BEGIN
+  n := 0;
+
+  n := Step(5) + buf[n]
+END Test8.
@@ -0,0 +1,39 @@
+MODULE Test9;
+
+VAR
+n*: INTEGER;
+
+PROCEDURE Square(x: INTEGER): INTEGER;
+BEGIN
+  RETURN x * x
+END Square;
+
+PROCEDURE Digits(x: INTEGER): INTEGER;
+VAR d: INTEGER;
+BEGIN
+  d := 1;
+  WHILE x >= 10 DO x := x DIV 10; INC(d) END;
+  RETURN d
+END Digits;
+
+PROCEDURE Fact*(k: INTEGER): INTEGER;
+BEGIN
+  IF k <= 1 THEN RETURN 1 END;
+  RETURN k * Fact(k - 1)
+END Fact;
+
+PROCEDURE Sum*(k: INTEGER);
+VAR i: INTEGER;
+BEGIN
+  i := 0;
+  WHILE i < k DO
+    n := n + Square(i) + Digits(i);
+    INC(i)
+  END
+END Sum;
+
+BEGIN
+  n := 0;
+  Sum(10);
+  n := n + Fact(5)
+END Test9.